@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_CACHE_H__
+#define __MP3_CACHE_H__
+
+#include <stdint.h>
+#include <rtthread.h>
+#include "mp3_player.h"
+
+#ifndef MP3_PLAYER_CACHE_PATH
+#define MP3_PLAYER_CACHE_PATH "/mp3_cache.bin"
+#endif
+
+/* record slots of the cache file,power of two */
+#ifndef MP3_CACHE_SLOTS
+#define MP3_CACHE_SLOTS (8192)
+#endif
+
+/* slots visited per lookup before giving up */
+#ifndef MP3_CACHE_MAX_PROBES
+#define MP3_CACHE_MAX_PROBES (16)
+#endif
+
+/*
+ * cache file layout
+ *
+ * a header followed by MP3_CACHE_SLOTS fixed size records,a path is
+ * hashed to its first slot and collisions step by a second hash,so a
+ * lookup is one seek and one sequential read in most cases.
+ */
+struct mp3_cache_header
+{
+    uint8_t magic[4];     /* "MP3C" */
+    uint32_t version;
+    uint32_t record_size; /* changes with mp3_info_t,cache is rebuilt */
+    uint32_t slots;
+};
+
+struct mp3_cache_key
+{
+    uint32_t magic; /* MP3_CACHE_RECORD_MAGIC if slot is used */
+    uint32_t hash;  /* FNV-1a of path */
+    uint32_t hash2; /* djb2 of path,also the probe step */
+    uint32_t size;  /* file size */
+    uint32_t mtime; /* file modification time */
+};
+
+/*
+ * cache structure definition
+ */
+struct mp3_cache
+{
+    int fd;
+    uint32_t slots;
+    rt_mutex_t lock;
+    uint32_t hits;
+    uint32_t misses;
+};
+
+/**
+ * @description: open cache file,it is created or rebuilt if it does not match,
+ *               a new file is preallocated with all its slots
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {uint32_t} slots record slots,power of two
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_cache_open(struct mp3_cache *cache, const char *path, uint32_t slots);
+
+/**
+ * @description: close cache file
+ * @param {struct mp3_cache} *cache
+ * @return None
+ */
+void mp3_cache_close(struct mp3_cache *cache);
+
+/**
+ * @description: look up mp3 info of a file,the file is not opened
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {mp3_info_t} *info
+ * @return the error code,0 on success,RT_ERROR if not cached or file size/mtime changed
+ */
+rt_err_t mp3_cache_get(struct mp3_cache *cache, const char *path, mp3_info_t *info);
+
+/**
+ * @description: add or update mp3 info of a file
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {const mp3_info_t} *info
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_cache_put(struct mp3_cache *cache, const char *path, const mp3_info_t *info);
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_FILE_H__
+#define __MP3_FILE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <rtthread.h>
+
+/*
+ * define MP3_PLAYER_USING_RAW_FILE to read files with DFS open/read/lseek,
+ * data goes straight into the player buffers without the stdio FILE buffer.
+ * otherwise files are read with fopen/fread/fseek.
+ */
+
+#ifdef MP3_PLAYER_USING_RAW_FILE
+typedef int mp3_file_t;
+#define MP3_FILE_NULL (-1)
+#else
+typedef FILE *mp3_file_t;
+#define MP3_FILE_NULL RT_NULL
+#endif
+
+/**
+ * @description: open file for reading
+ * @param {const char} *path
+ * @return file,MP3_FILE_NULL on error
+ */
+mp3_file_t mp3_file_open(const char *path);
+
+/**
+ * @description: close file
+ * @param {mp3_file_t} file
+ * @return None
+ */
+void mp3_file_close(mp3_file_t file);
+
+/**
+ * @description: read from current position
+ * @param {mp3_file_t} file
+ * @param {void} *buf
+ * @param {uint32_t} len
+ * @return bytes read,0 on end of file or error
+ */
+uint32_t mp3_file_read(mp3_file_t file, void *buf, uint32_t len);
+
+/**
+ * @description: move current position
+ * @param {mp3_file_t} file
+ * @param {long} offset
+ * @param {int} whence SEEK_SET,SEEK_CUR or SEEK_END
+ * @return 0 on success,-1 on error
+ */
+int mp3_file_seek(mp3_file_t file, long offset, int whence);
+
+/**
+ * @description: get current position
+ * @param {mp3_file_t} file
+ * @return current position,-1 on error
+ */
+long mp3_file_tell(mp3_file_t file);
+
+/**
+ * @description: get file size
+ * @param {mp3_file_t} file
+ * @return file size,-1 on error
+ */
+long mp3_file_size(mp3_file_t file);
+
+#endif
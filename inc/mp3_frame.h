@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_FRAME_H__
+#define __MP3_FRAME_H__
+
+#include <stdint.h>
+#include <rtthread.h>
+#include "mp3_file.h"
+
+#define MP3_FRAME_HEADER_SIZE (4)
+
+/* most frames decoded silently before a seek target to refill the bit reservoir */
+#ifndef MP3_PREROLL_FRAMES_MAX
+#define MP3_PREROLL_FRAMES_MAX (16)
+#endif
+
+/* frame headers following a candidate sync that must agree with it */
+#ifndef MP3_SYNC_CONFIRM_FRAMES
+#define MP3_SYNC_CONFIRM_FRAMES (2)
+#endif
+
+/*
+ *  mpeg audio frame header
+ */
+typedef struct
+{
+    uint8_t version;     /* MPEG1/MPEG2/MPEG25 */
+    uint8_t layer;       /* 1 ~ 3 */
+    uint8_t channels;    /* 1 or 2 */
+    uint8_t padding;     /* padding slot present */
+    uint32_t bitrate;    /* bit/s */
+    uint32_t samplerate; /* Hz */
+    uint16_t samples;    /* samples per channel in this frame */
+    uint16_t frame_size; /* bytes, header included */
+} mp3_frame_header_t;
+
+/**
+ * @description: frame walk callback
+ * @param {void} *user
+ * @param {uint32_t} frame frame number,counted from the walk start
+ * @param {uint32_t} offset file offset of the frame
+ * @param {mp3_frame_header_t} *header
+ * @return RT_EOK to continue,others stop the walk
+ */
+typedef rt_err_t (*mp3_frame_walk_cb)(void *user, uint32_t frame, uint32_t offset, const mp3_frame_header_t *header);
+
+/**
+ * @description: parse a 4 bytes mpeg audio frame header
+ * @param {uint8_t} *buf
+ * @param {mp3_frame_header_t} *header
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_frame_header_parse(const uint8_t *buf, mp3_frame_header_t *header);
+
+/**
+ * @description: check if two frame headers belong to the same stream
+ * @param {const mp3_frame_header_t} *a
+ * @param {const mp3_frame_header_t} *b
+ * @return RT_TRUE if version,layer and samplerate agree
+ */
+rt_bool_t mp3_frame_header_match(const mp3_frame_header_t *a, const mp3_frame_header_t *b);
+
+/**
+ * @description: find a frame sync confirmed by the frame headers following it,
+ *               a bad region is skipped in one call
+ * @param {const uint8_t} *buf
+ * @param {uint32_t} len
+ * @param {uint8_t} eof no data follows buf
+ * @param {const mp3_frame_header_t} *ref header of the stream,a candidate that can not be
+ *                                     confirmed at the end of data must agree with it,can be RT_NULL
+ * @param {uint32_t} *offset offset of the sync,or bytes that can be dropped if none is found
+ * @return the error code,RT_EOK if a sync is found
+ */
+rt_err_t mp3_frame_sync(const uint8_t *buf, uint32_t len, uint8_t eof, const mp3_frame_header_t *ref, uint32_t *offset);
+
+/**
+ * @description: walk frame headers without decoding
+ * @param {mp3_file_t} fp
+ * @param {uint32_t} offset file offset of the first frame
+ * @param {uint32_t} end file offset where audio data ends
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size, no less than 512 bytes
+ * @param {mp3_frame_walk_cb} cb called for every frame
+ * @param {void} *user
+ * @param {volatile rt_uint8_t} *cancel walk stops when it becomes non-zero,can be RT_NULL
+ * @return frames walked
+ */
+uint32_t mp3_frame_walk(mp3_file_t fp, uint32_t offset, uint32_t end, uint8_t *buf, uint32_t size,
+                        mp3_frame_walk_cb cb, void *user, volatile rt_uint8_t *cancel);
+
+/**
+ * @description: locate the frame that is a number of frames after a given frame,
+ *               then back up over the frames that hold its bit reservoir
+ * @param {mp3_file_t} fp
+ * @param {uint32_t} offset file offset of the start frame
+ * @param {uint32_t} frames frames to skip,headers that do not match the start frame are not counted
+ * @param {uint32_t} *preroll frames before the located one that are decoded but not played
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size
+ * @return file offset of the first preroll frame
+ */
+uint32_t mp3_frame_locate_preroll(mp3_file_t fp, uint32_t offset, uint32_t frames, uint32_t *preroll,
+                                  uint8_t *buf, uint32_t size);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_ID3V2_H__
+#define __MP3_ID3V2_H__
+
+#include <stdint.h>
+#include "mp3_tag.h"
+
+/* tag bytes read from the file per track,frames past it are not parsed */
+#ifndef MP3_ID3V2_READ_BUDGET
+#define MP3_ID3V2_READ_BUDGET (64 * 1024)
+#endif
+
+/* milliseconds spent on the tag frames per track */
+#ifndef MP3_ID3V2_TIME_BUDGET_MS
+#define MP3_ID3V2_TIME_BUDGET_MS (100)
+#endif
+
+/**
+ * @description: picture chunk callback
+ * @param {const uint8_t} *data
+ * @param {uint32_t} size
+ * @param {void} *user
+ * @return the error code,streaming stops if it is not 0
+ */
+typedef rt_err_t (*mp3_picture_cb_t)(const uint8_t *data, uint32_t size, void *user);
+
+/**
+ * @description: get whole tag size from the ID3v2 header
+ * @param {const uint8_t} *header first 10 bytes of the file
+ * @return {uint32_t} whole tag size with header and footer,0 if there is no tag
+ */
+uint32_t mp3_id3v2_tag_size(const uint8_t *header);
+
+/**
+ * @description: parse ID3v2.2/2.3/2.4 tag at the file start,the tag is streamed through buf,
+ *               no memory is allocated
+ * @param {mp3_file_t} fp
+ * @param {mp3_basic_info_t} *basic_info only fields found in the tag are written
+ * @param {uint8_t} *buf window the tag is read through
+ * @param {uint32_t} size window size,no less than 16 bytes
+ * @return {uint32_t} whole tag size,0 if there is no tag
+ */
+uint32_t mp3_id3v2_parse(mp3_file_t fp, mp3_basic_info_t *basic_info, uint8_t *buf, uint32_t size);
+
+/**
+ * @description: read a chunk of an embedded picture
+ * @param {mp3_file_t} fp file the picture was found in
+ * @param {const mp3_picture_t} *picture
+ * @param {uint32_t} pos offset in the image
+ * @param {uint8_t} *buf
+ * @param {uint32_t} size buf size
+ * @return {uint32_t} bytes read,0 at the end of image or on error
+ */
+uint32_t mp3_picture_read(mp3_file_t fp, const mp3_picture_t *picture, uint32_t pos, uint8_t *buf, uint32_t size);
+
+/**
+ * @description: stream an embedded picture to a callback in fixed size chunks,
+ *               the file is opened separately so playback of it goes on
+ * @param {const char} *path file the picture was found in
+ * @param {const mp3_picture_t} *picture
+ * @param {uint8_t} *buf chunk buffer
+ * @param {uint32_t} size chunk size
+ * @param {mp3_picture_cb_t} cb called for every chunk
+ * @param {void} *user passed to cb
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_picture_stream(const char *path, const mp3_picture_t *picture, uint8_t *buf, uint32_t size,
+                            mp3_picture_cb_t cb, void *user);
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_INPUT_H__
+#define __MP3_INPUT_H__
+
+#include <stdint.h>
+#include <rtthread.h>
+
+/* refill unit of the input ring, file reads are aligned to it */
+#ifndef MP3_INPUT_BLOCK_SIZE
+#define MP3_INPUT_BLOCK_SIZE (512)
+#endif
+
+/*
+ * mp3 input ring structure definition
+ *
+ * single producer / single consumer byte ring, the first mirror_size bytes
+ * of the ring are duplicated right after its end, so any window of up to
+ * mirror_size bytes is contiguous and can be handed to helix as is.
+ * head and tail are free running byte counters, size is a power of two.
+ */
+struct mp3_input
+{
+    uint8_t *buffer;
+    uint32_t size;        /* ring size */
+    uint32_t block_size;  /* refill unit */
+    uint32_t mirror_size; /* bytes mirrored after the ring end */
+
+    volatile uint32_t head; /* bytes produced */
+    volatile uint32_t tail; /* bytes consumed */
+    volatile uint8_t eof;   /* producer reached end of data */
+};
+
+/**
+ * @description: init input ring
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} size min ring size,rounded up to a power of two
+ * @param {uint32_t} block_size refill unit,power of two
+ * @param {uint32_t} mirror_size max contiguous window needed by the consumer
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_input_init(struct mp3_input *in, uint32_t size, uint32_t block_size, uint32_t mirror_size);
+
+/**
+ * @description: free input ring
+ * @param {struct mp3_input} *in
+ * @return None
+ */
+void mp3_input_deinit(struct mp3_input *in);
+
+/**
+ * @description: drop all data,next data produced comes from a file offset
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} file_offset keeps reads aligned to blocks of the file
+ * @return None
+ */
+void mp3_input_reset(struct mp3_input *in, uint32_t file_offset);
+
+/**
+ * @description: get buffered bytes
+ * @param {struct mp3_input} *in
+ * @return buffered bytes
+ */
+uint32_t mp3_input_used(struct mp3_input *in);
+
+/**
+ * @description: get space for the next read,only when a whole block is free
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} *len contiguous free bytes,ending on a block boundary
+ * @return write pointer,RT_NULL if ring is full
+ */
+uint8_t *mp3_input_write_ptr(struct mp3_input *in, uint32_t *len);
+
+/**
+ * @description: publish bytes written to the write pointer
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} len
+ * @return None
+ */
+void mp3_input_produce(struct mp3_input *in, uint32_t len);
+
+/**
+ * @description: get contiguous window of buffered data
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} *len contiguous bytes,at least min(buffered,mirror_size)
+ * @return read pointer
+ */
+uint8_t *mp3_input_read_ptr(struct mp3_input *in, uint32_t *len);
+
+/**
+ * @description: drop bytes from the read pointer
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} len
+ * @return None
+ */
+void mp3_input_consume(struct mp3_input *in, uint32_t len);
+
+#endif
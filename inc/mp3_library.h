@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_LIBRARY_H__
+#define __MP3_LIBRARY_H__
+
+#include <stdint.h>
+#include <rtthread.h>
+
+/* tracks are probed into the info cache,without it the library stores nothing */
+#if defined(MP3_PLAYER_USING_LIBRARY) && !defined(MP3_PLAYER_USING_CACHE)
+#error "MP3_PLAYER_USING_LIBRARY needs MP3_PLAYER_USING_CACHE"
+#endif
+
+#ifndef MP3_LIBRARY_INDEX_PATH
+#define MP3_LIBRARY_INDEX_PATH "/mp3_library.bin"
+#endif
+
+/* longest file or directory name kept in the index */
+#ifndef MP3_LIBRARY_NAME_MAX
+#define MP3_LIBRARY_NAME_MAX (64)
+#endif
+
+/* longest path walked */
+#ifndef MP3_LIBRARY_PATH_MAX
+#define MP3_LIBRARY_PATH_MAX (256)
+#endif
+
+/* deepest directory level walked */
+#ifndef MP3_LIBRARY_DEPTH_MAX
+#define MP3_LIBRARY_DEPTH_MAX (8)
+#endif
+
+/* files probed before the scanner sleeps MP3_LIBRARY_YIELD_MS */
+#ifndef MP3_LIBRARY_YIELD_FILES
+#define MP3_LIBRARY_YIELD_FILES (4)
+#endif
+
+#ifndef MP3_LIBRARY_YIELD_MS
+#define MP3_LIBRARY_YIELD_MS (10)
+#endif
+
+enum MP3_LIBRARY_RECORD_TYPE
+{
+    MP3_LIBRARY_DIR = 1,
+    MP3_LIBRARY_TRACK = 2,
+};
+
+enum MP3_LIBRARY_STATE
+{
+    MP3_LIBRARY_IDLE = 0,
+    MP3_LIBRARY_SCANNING = 1,
+    MP3_LIBRARY_DONE = 2,
+    MP3_LIBRARY_FAILED = 3, /* cancelled or file error,the last index is kept */
+};
+
+/*
+ * library index file layout
+ *
+ * a header followed by fixed size records,record 0 is the scanned root.
+ * children of a directory are contiguous records [first, first + count),
+ * so a directory whose mtime did not change is copied from the last index
+ * without reading it again.
+ */
+struct mp3_library_header
+{
+    uint8_t magic[4]; /* "MP3L" */
+    uint32_t version;
+    uint32_t records;
+    uint32_t tracks;
+};
+
+struct mp3_library_record
+{
+    uint8_t type; /* MP3_LIBRARY_DIR or MP3_LIBRARY_TRACK */
+    uint8_t reserved[3];
+    uint32_t parent; /* record of the parent directory */
+    uint32_t mtime;  /* directory only */
+    uint32_t first;  /* directory only,first child record */
+    uint32_t count;  /* directory only,child records */
+    char name[MP3_LIBRARY_NAME_MAX]; /* name in parent,root path for record 0 */
+};
+
+/*
+ * scan progress
+ */
+struct mp3_library_progress
+{
+    uint8_t state;         /* enum MP3_LIBRARY_STATE */
+    uint32_t dirs;         /* directories read */
+    uint32_t dirs_skipped; /* unchanged directories taken from the last index */
+    uint32_t files;        /* mp3 files probed */
+    uint32_t cached;       /* mp3 files found in the metadata cache */
+    uint32_t pauses;       /* times the scanner waited for playback to recover */
+    uint32_t records;      /* records written */
+    uint32_t tracks;       /* tracks found */
+};
+
+/**
+ * @description: start scanning a directory tree in background,
+ *               tags and duration of mp3 files go to the metadata cache
+ * @param {const char} *root kept as the name of the first record,shorter than MP3_LIBRARY_NAME_MAX
+ * @return the error code,0 on success,-RT_EINVAL if root is too long,-RT_EBUSY if a scan is running
+ */
+rt_err_t mp3_library_scan(const char *root);
+
+/**
+ * @description: stop a running scan,the last index is kept
+ * @param None
+ * @return None
+ */
+void mp3_library_cancel(void);
+
+/**
+ * @description: get scan progress
+ * @param {struct mp3_library_progress} *progress
+ * @return None
+ */
+void mp3_library_progress_get(struct mp3_library_progress *progress);
+
+/**
+ * @description: get record and track count of the library index
+ * @param {uint32_t} *records
+ * @param {uint32_t} *tracks
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_library_info_get(uint32_t *records, uint32_t *tracks);
+
+/**
+ * @description: get path of a track in the library index
+ * @param {uint32_t} index record index,[0, records)
+ * @param {char} *path
+ * @param {uint32_t} size path size
+ * @return the error code,0 on success,RT_ERROR if the record is not a track
+ */
+rt_err_t mp3_library_track_path(uint32_t index, char *path, uint32_t size);
+
+#endif
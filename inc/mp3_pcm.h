@@ -0,0 +1,200 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_PCM_H__
+#define __MP3_PCM_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+/* pcm ring size, in decoded frames */
+#ifndef MP3_PCM_RING_FRAMES
+#define MP3_PCM_RING_FRAMES (6)
+#endif
+
+/* decoder stops running ahead and output starts playing at this many frames */
+#ifndef MP3_PCM_HIGH_WATERMARK
+#define MP3_PCM_HIGH_WATERMARK (4)
+#endif
+
+/* decoder is woken up again when the ring drops to this many frames */
+#ifndef MP3_PCM_LOW_WATERMARK
+#define MP3_PCM_LOW_WATERMARK (2)
+#endif
+
+/* bytes handed to the sound device per write, partial frames are merged up to it */
+#ifndef MP3_OUTPUT_PERIOD_SIZE
+#ifdef RT_AUDIO_REPLAY_MP_BLOCK_SIZE
+#define MP3_OUTPUT_PERIOD_SIZE RT_AUDIO_REPLAY_MP_BLOCK_SIZE
+#else
+#define MP3_OUTPUT_PERIOD_SIZE MP3_OUTPUT_BUFFER_SIZE
+#endif
+#endif
+
+/*
+ * define MP3_PLAYER_USING_ZERO_COPY to decode straight into the replay
+ * blocks of the RT-Thread audio framework instead of the pcm ring, it
+ * falls back to the ring when the device can not lend blocks.
+ */
+
+enum PCM_OUTPUT_STATE
+{
+    PCM_OUTPUT_STATE_STOPPED = 0,
+    PCM_OUTPUT_STATE_RUNNING = 1,
+    PCM_OUTPUT_STATE_PAUSED = 2,
+};
+
+/*
+ * pcm output stage structure definition
+ *
+ * single producer(decoder thread) / single consumer(output thread) ring,
+ * a frame sized tail follows the ring so the decoder can always write a
+ * whole frame contiguously, the part beyond the ring end is folded back
+ * to the head on commit.
+ *
+ * in zero copy mode the replay block pool of the sound device takes the
+ * place of the ring and the output thread stays idle.
+ */
+struct mp3_pcm_output
+{
+    rt_uint8_t *buffer;
+    rt_uint32_t size;       /* ring size in bytes */
+    rt_uint32_t frame_size; /* max bytes of one decoded frame */
+    rt_uint32_t period_size; /* bytes per device write */
+    rt_uint32_t high_watermark;
+    rt_uint32_t low_watermark;
+
+    volatile rt_uint32_t read_pos;
+    volatile rt_uint32_t write_pos;
+    volatile rt_uint8_t state;
+    volatile rt_uint8_t prefill;
+    volatile rt_uint8_t draining;
+    rt_uint8_t throttled;
+    rt_uint32_t samplerate;       /* current samplerate of the device */
+    volatile rt_uint32_t samples; /* samples per channel handed to the device */
+    volatile rt_tick_t first_tick; /* tick of the first device write since start,0 if none */
+
+    rt_uint8_t zero_copy; /* blocks are borrowed from the sound device */
+    rt_uint8_t *block;    /* reserved block not committed yet */
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    /* bytes of the last blocks pushed,the replay queue never holds more than the pool */
+    rt_uint32_t pushed[RT_AUDIO_REPLAY_MP_BLOCK_COUNT];
+    rt_uint32_t pushes;
+#endif
+
+    rt_device_t device;
+    rt_event_t event;
+    rt_thread_t tid;
+};
+
+/**
+ * @description: init pcm output stage and start the output thread
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} frame_size max bytes of one decoded frame
+ * @param {rt_uint32_t} frames ring size in frames
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_pcm_output_init(struct mp3_pcm_output *out, rt_uint32_t frame_size, rt_uint32_t frames);
+
+/**
+ * @description: start feeding the sound device,samplerate set by the last start is kept for the same device
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_device_t} device opened sound device
+ * @return None
+ */
+void mp3_pcm_output_start(struct mp3_pcm_output *out, rt_device_t device);
+
+/**
+ * @description: stop output and discard all queued pcm
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_stop(struct mp3_pcm_output *out);
+
+/**
+ * @description: stop output and forget the sound device,called before it is closed
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_release(struct mp3_pcm_output *out);
+
+/**
+ * @description: discard all queued pcm and build up margin again,the state is kept
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_flush(struct mp3_pcm_output *out);
+
+/**
+ * @description: pause or resume output
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_bool_t} pause
+ * @return None
+ */
+void mp3_pcm_output_pause(struct mp3_pcm_output *out, rt_bool_t pause);
+
+/**
+ * @description: set samplerate of the sound device,queued pcm of the old samplerate is played first
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} samplerate
+ * @return None
+ */
+void mp3_pcm_output_configure(struct mp3_pcm_output *out, rt_uint32_t samplerate);
+
+/**
+ * @description: wait until all queued pcm has been written to the device
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_drain(struct mp3_pcm_output *out);
+
+/**
+ * @description: get space for one decoded frame
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_int32_t} timeout ticks to wait for the ring to drain to low watermark
+ * @return pointer to at least frame_size writable bytes,RT_NULL if decoder should wait
+ */
+rt_uint8_t *mp3_pcm_output_reserve(struct mp3_pcm_output *out, rt_int32_t timeout);
+
+/**
+ * @description: queue bytes written to the reserved space
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} size bytes written, no more than frame_size
+ * @return None
+ */
+void mp3_pcm_output_commit(struct mp3_pcm_output *out, rt_uint32_t size);
+
+/**
+ * @description: get queued pcm bytes
+ * @param {struct mp3_pcm_output} *out
+ * @return queued bytes
+ */
+rt_uint32_t mp3_pcm_output_used(struct mp3_pcm_output *out);
+
+/**
+ * @description: get samples handed to the sound device since start
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_samples(struct mp3_pcm_output *out);
+
+/**
+ * @description: get samples queued to the output stage since start,played or not
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_committed(struct mp3_pcm_output *out);
+
+/**
+ * @description: get samples the sound device has played since start,
+ *               pcm in the dma buffer of the audio framework is estimated
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_played(struct mp3_pcm_output *out);
+
+#endif
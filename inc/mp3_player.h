@@ -12,6 +12,46 @@
 #include <rtdevice.h>
 
 #include "mp3dec.h" /* helix include files */
+#include "mp3_pcm.h"
+#include "mp3_seek_index.h"
+#include "mp3_file.h"
+#include "mp3_frame.h"
+#include "mp3_input.h"
+#include "mp3_readahead.h"
+#include "mp3_stats.h"
+
+/*
+ * define MP3_PLAYER_USING_FAST_START to start decoding right after the
+ * ID3v2 header, tags and vbr header are parsed by the background thread,
+ * MP3_PLAYER_NOTIFY_METADATA is raised once mp3 info is complete.
+ */
+
+/*
+ * define MP3_PLAYER_USING_GAPLESS to splice a queued track without
+ * closing the sound device, encoder delay and padding from the LAME tag
+ * are trimmed so the tracks join sample accurately.
+ */
+
+/*
+ * define MP3_PLAYER_USING_CACHE to keep parsed mp3 info in MP3_PLAYER_CACHE_PATH,
+ * a track played before starts without parsing its tags and vbr header.
+ */
+
+/*
+ * define MP3_PLAYER_USING_EXACT_DURATION to count the frames of files without
+ * a Xing/VBRI header,the background thread takes them from its seek index walk,
+ * MP3_PLAYER_NOTIFY_DURATION is raised once the duration is exact.
+ */
+
+/*
+ * define MP3_PLAYER_USING_LIBRARY (needs MP3_PLAYER_USING_CACHE) to scan
+ * directory trees on a low priority thread, see mp3_library.h.
+ */
+
+/* longest path mp3_probe_dir builds */
+#ifndef MP3_PROBE_PATH_MAX
+#define MP3_PROBE_PATH_MAX (256)
+#endif
 
 enum MSG_TYPE
 {
@@ -20,6 +60,9 @@ enum MSG_TYPE
     MSG_STOP = 2,
     MSG_PAUSE = 3,
     MSG_RESUME = 4,
+    MSG_SEEK = 5,   /* no ack,takes the latest seek_request_ms */
+    MSG_VOLUME = 6, /* no ack,takes the latest volume */
+    MSG_BENCH = 7,  /* data is a struct mp3_bench,acked once it is done */
 };
 
 enum PLAYER_EVENT
@@ -31,6 +74,20 @@ enum PLAYER_EVENT
     PLAYER_EVENT_RESUME = 4,
 };
 
+enum MP3_PLAYER_NOTIFY
+{
+    MP3_PLAYER_NOTIFY_METADATA = 0, /* mp3 info of current track is complete */
+    MP3_PLAYER_NOTIFY_DURATION = 1, /* exact duration of current track is known */
+};
+
+/**
+ * @description: player notification callback,called in the player thread
+ * @param {int} notify enum MP3_PLAYER_NOTIFY
+ * @param {void} *user
+ * @return None
+ */
+typedef void (*mp3_player_notify_t)(int notify, void *user);
+
 struct play_msg
 {
     int type;
@@ -45,6 +102,36 @@ typedef struct
     int bytes_left;
 } decode_oper_t;
 
+/* user defined text frames (TXXX) kept per track */
+#ifndef MP3_TXXX_MAX
+#define MP3_TXXX_MAX (2)
+#endif
+
+/* 
+ * user defined text,utf-8
+ */
+typedef struct
+{
+    uint8_t desc[24];
+    uint8_t value[24];
+} mp3_txxx_t;
+
+/* embedded pictures (APIC) recorded per track */
+#ifndef MP3_PICTURE_MAX
+#define MP3_PICTURE_MAX (2)
+#endif
+
+/* 
+ * embedded picture,the image stays in the file
+ */
+typedef struct
+{
+    uint32_t offset;  /* file offset of the image data */
+    uint32_t length;  /* image bytes */
+    uint8_t type;     /* picture type,3: front cover */
+    uint8_t mime[16]; /* "image/jpeg","image/png" */
+} mp3_picture_t;
+
 /* 
  * music basic info structure definition
  */
@@ -55,8 +142,18 @@ typedef struct
     uint8_t year[4];
     uint8_t comment[30];
     uint8_t genre;
+    uint8_t album[30];
+    uint8_t track[8];       /* "3" or "3/12" */
+    uint8_t genre_text[30]; /* genre name from the ID3v2 tag,empty if only genre id is known */
+    uint32_t length_ms;     /* TLEN,0 if not present */
+    uint8_t txxx_count;
+    mp3_txxx_t txxx[MP3_TXXX_MAX];
+    uint8_t picture_count;
+    mp3_picture_t picture[MP3_PICTURE_MAX];
 } mp3_basic_info_t;
 
+#define MP3_TOC_SIZE (100)
+
 /* 
  * mp3_info structure definition
  */
@@ -70,8 +167,23 @@ typedef struct
     uint32_t samplerate;
     uint16_t outsamples;
     uint8_t vbr;
-    uint32_t data_start;
+    uint32_t data_start; /* file offset of the first frame */
+    uint32_t data_end;   /* file offset where audio data ends,before the ID3v1 tag */
     long file_size;
+
+    /* vbr seek table, from Xing TOC or VBRI table */
+    uint32_t total_frames;
+    uint32_t vbr_bytes; /* bytes covered by the toc,counted from data_start */
+    uint8_t toc_valid;
+    uint8_t toc[MP3_TOC_SIZE]; /* toc[i] * vbr_bytes / 256 is the offset at i% of duration */
+    uint32_t total_samples;    /* samples per channel,valid if total_frames is */
+    uint8_t exact;             /* total_frames counted by walking frame headers */
+
+    /* gapless info, from the LAME tag */
+    uint32_t audio_start; /* file offset of the first audio frame,after the Xing/VBRI frame */
+    uint16_t enc_delay;   /* samples inserted by the encoder at start */
+    uint16_t enc_padding; /* samples appended by the encoder at end */
+    uint8_t gapless;      /* enc_delay and enc_padding are valid */
 } mp3_info_t;
 
 /* 
@@ -84,10 +196,12 @@ struct mp3_player
     uint8_t *in_buffer;
     uint16_t *out_buffer;
     rt_device_t audio_device;
+    rt_uint8_t device_opened; /* kept open between tracks until idle timeout */
+    rt_tick_t start_tick;     /* tick of the last play start */
     rt_mq_t mq;
     rt_mutex_t lock;
     struct rt_completion ack;
-    FILE *fp;
+    mp3_file_t fp;
 
     int volume;
 
@@ -98,9 +212,101 @@ struct mp3_player
     mp3_info_t mp3_info;
 
     decode_oper_t decode_oper;
+
+    /* input ring helix decodes from, filled by read-ahead */
+    struct mp3_input *input;
+    struct mp3_readahead *readahead;
+
+    /* pcm ring drained by the output thread */
+    struct mp3_pcm_output *pcm;
+
+    /* latest seek and volume commands,one message of each is queued at most */
+    volatile uint32_t seek_request_ms;
+    volatile rt_uint8_t seek_queued;
+    volatile rt_uint8_t volume_queued;
+
+    /* seek request, applied by the player thread */
+    uint8_t seek_pending;
+    uint32_t seek_offset;
+    uint32_t seek_skip_frames;
+    uint32_t seek_frame;        /* target frame,UINT32_MAX if not known */
+    uint32_t seek_skip_samples; /* samples of the target frame before the position */
+    uint32_t seek_ms;           /* target position */
+    uint32_t preroll_frames;    /* frames still to decode silently after a seek */
+
+    /* frame sync,lost on decode errors and found again by mp3_frame_sync */
+    rt_uint8_t synced;               /* next frame starts at the read pointer */
+    mp3_frame_header_t sync_header;  /* last frame found,samplerate 0 if none in this track */
+    uint32_t resyncs;                /* times sync was lost */
+    uint32_t resync_bytes;           /* bytes skipped to find it again */
+
+    /* playback position,written by the player thread only,both fields under the interrupt lock */
+    uint32_t pos_base_ms; /* track position of the sample at pos_mark */
+    uint32_t pos_mark;    /* pcm output committed samples when pos_base_ms was set */
+
+    /* track played after the current one */
+    char *next_uri;
+    volatile uint32_t next_seq; /* bumped whenever next_uri is replaced */
+#ifdef MP3_PLAYER_USING_GAPLESS
+    /* queued track opened and parsed ahead by the background thread */
+    char *prepared_uri;
+    uint32_t prepared_seq; /* next_seq when prepared_uri was taken */
+    mp3_file_t prepared_fp;
+    mp3_info_t prepared_info;
+#endif
+
+    /* encoder delay/padding trimming */
+    uint32_t trim_skip;   /* samples still to drop */
+    uint32_t trim_remain; /* samples still to play,UINT32_MAX if not limited */
+
+    /* metadata parsed by the background thread */
+    mp3_info_t bg_info;
+    volatile rt_uint8_t info_ready; /* 1: bg_info is ready to be applied, 2: applied */
+    uint32_t track_frames;          /* frames decoded since track start */
+    volatile rt_uint8_t duration_ready; /* 1: exact duration in bg_info is ready to be applied, 2: applied */
+
+    mp3_player_notify_t notify;
+    void *notify_user;
+
+    /* parsed mp3 info of played files,RT_NULL if not used */
+    struct mp3_cache *cache;
+
+    /* seek index built by the background thread */
+    struct mp3_seek_index *seek_index;
+    volatile rt_uint8_t bg_cancel;
+    volatile rt_uint8_t bg_running; /* cleared when the background thread is done */
+    rt_thread_t bg_tid;
+    struct rt_completion bg_done;
 };
 #pragma pack()
 
+/*
+ * decode-only benchmark of one file,see mp3_player_bench
+ */
+struct mp3_bench
+{
+    const char *uri;
+    rt_err_t result;
+
+    uint32_t frames;      /* frames decoded */
+    uint32_t errors;      /* frames that failed to decode */
+    uint32_t resyncs;     /* times the frame sync was lost */
+    uint32_t samples;     /* samples per channel decoded */
+    uint32_t samplerate;
+    rt_tick_t ticks;      /* time of the whole run */
+
+    /* read+sync+decode time of one frame,in cpu cycles if cycles is set,else in ticks */
+    rt_uint8_t cycles;
+    uint32_t frame_min;
+    uint32_t frame_max;
+    uint64_t frame_total;
+
+    rt_size_t heap_peak;  /* highest heap use since boot,not only of the run,0 without RT_USING_HEAP */
+    rt_size_t heap_grown; /* bytes the run raised heap_peak by,0 if it stayed below an earlier peak */
+    uint32_t stack_used;  /* stack high-water mark of the player thread */
+    uint32_t stack_size;
+};
+
 /**
  * mp3 player status
  */
@@ -122,6 +328,18 @@ enum PLAYER_STATE
  */
 int mp3_player_play(char *uri);
 
+/**
+ * @brief             Queue the music played after the current one,
+ *                    dropped by mp3_player_play and mp3_player_stop
+ *
+ * @param uri         the pointer for file path,RT_NULL to clear the queue
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int mp3_player_queue_next(char *uri);
+
 /**
  * @brief             Stop music
  *
@@ -184,6 +402,155 @@ int mp3_player_state_get(void);
  */
 char *mp3_player_uri_get(void);
 
+/**
+ * @brief             Get pcm samples written to the sound device
+ *
+ * @return            samples per channel since play start
+ */
+uint32_t mp3_player_samples_get(void);
+
+/**
+ * @brief             Get playback position of the current track,counted from the samples
+ *                    the sound device has played,lock free and cheap enough to poll from a UI
+ *
+ * @return            position in milliseconds,0 if stopped
+ */
+uint32_t mp3_player_position_ms(void);
+
+/**
+ * @brief             Set callback of player notifications
+ *
+ * @param notify      callback,RT_NULL to remove
+ * @param user        passed to the callback
+ */
+void mp3_player_notify_set(mp3_player_notify_t notify, void *user);
+
+/**
+ * @brief             Get time to first sample of the last play start
+ *
+ * @return            milliseconds from play start to the first pcm written to the sound device,
+ *                    0 if no pcm has been written yet
+ */
+uint32_t mp3_player_first_sample_ms(void);
+
+/**
+ * @brief             Get an embedded picture of the current track,read its image
+ *                    with mp3_picture_read or mp3_picture_stream
+ *
+ * @param index       picture index,from 0
+ * @param picture     picture info
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed,no such picture
+ */
+int mp3_player_picture_get(int index, mp3_picture_t *picture);
+
+/**
+ * @brief             Get mp3 info of a file from the metadata cache,the file is not opened
+ *
+ * @param uri         the pointer for file path
+ * @param info        mp3 info
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed,not cached,changed since or MP3_PLAYER_USING_CACHE is not defined
+ */
+int mp3_player_info_cached(const char *uri, mp3_info_t *info);
+
+/**
+ * @brief             Parse mp3 info of a file without a decoder,the player is not used,
+ *                    so it can be called from any thread while a track is playing
+ *
+ * @param path        the pointer for file path
+ * @param info        mp3 info
+ * @param scratch     scratch buffer,no less than 512 bytes,a few KB reads the ID3v2 tag in fewer reads
+ * @param size        scratch buffer size
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+rt_err_t mp3_probe(const char *path, mp3_info_t *info, uint8_t *scratch, uint32_t size);
+
+/**
+ * @brief             Parse mp3 info of a file like mp3_probe,files without a Xing/VBRI header
+ *                    get their exact duration,frame count and average bitrate by walking
+ *                    frame headers,audio is not decoded
+ *
+ * @param path        the pointer for file path
+ * @param info        mp3 info
+ * @param scratch     scratch buffer,no less than 512 bytes,tens of KB keeps the walk in few large reads
+ * @param size        scratch buffer size
+ * @param cancel      walk stops when it becomes non-zero,can be RT_NULL
+ *
+ * @return
+ *      - 0      Success
+ *      - -RT_EINTR Cancelled
+ *      - others Failed
+ */
+rt_err_t mp3_probe_exact(const char *path, mp3_info_t *info, uint8_t *scratch, uint32_t size,
+                         volatile rt_uint8_t *cancel);
+
+/**
+ * @brief             Parse mp3 info of files in one directory,e.g. the visible part of a playlist
+ *
+ * @param dir         directory of the files
+ * @param names       file names in dir
+ * @param count       number of files
+ * @param infos       mp3 info of each file,zeroed for files that fail
+ * @param scratch     scratch buffer shared by all files,no less than 512 bytes
+ * @param size        scratch buffer size
+ *
+ * @return            number of files parsed
+ */
+uint32_t mp3_probe_dir(const char *dir, const char *const *names, uint32_t count,
+                       mp3_info_t *infos, uint8_t *scratch, uint32_t size);
+
+/**
+ * @brief             Get metadata cache of the player
+ *
+ * @return            cache,RT_NULL if MP3_PLAYER_USING_CACHE is not defined or the cache file can't be opened
+ */
+struct mp3_cache *mp3_player_cache_get(void);
+
+/**
+ * @brief             Check if playback is running short of pcm,
+ *                    background work should give way to it
+ *
+ * @return            1 if playing and the pcm ring is below its low watermark
+ */
+int mp3_player_underrun_get(void);
+
+/**
+ * @brief             Get read-ahead statistics
+ *
+ * @param level       percent of the input ring filled
+ * @param stalls      times the decoder found the input empty
+ */
+void mp3_player_readahead_get(uint32_t *level, uint32_t *stalls);
+
+/**
+ * @brief             Get resync statistics
+ *
+ * @param events      times the frame sync was lost
+ * @param bytes       bytes skipped to find it again
+ */
+void mp3_player_resync_get(uint32_t *events, uint32_t *bytes);
+
+/**
+ * @brief             Decode a file as fast as possible without playing it,the read,
+ *                    sync and decode path of playback runs on the player thread,
+ *                    frames are timed in cpu cycles with the DWT cycle counter
+ *                    on Cortex-M3/M4/M7/M33,else in ticks
+ *
+ * @param uri         the pointer for file path
+ * @param bench       result
+ *
+ * @return            the error code,0 on success,-RT_EBUSY if the player is not stopped
+ */
+int mp3_player_bench(const char *uri, struct mp3_bench *bench);
+
 /**
  * @brief             show mp3 info
  */
@@ -201,4 +568,16 @@ void mp3_disp_time(void);
  */
 rt_err_t mp3_seek(uint32_t seconds);
 
+/**
+ * @brief             seek to destination milliseconds,the frames holding the bit reservoir
+ *                    of the target frame are decoded silently and samples before the
+ *                    position are dropped,so playback starts at the exact sample once
+ *                    the seek index covers the position
+ *
+ * @param ms          position in milliseconds
+ *
+ * @return            the error code,0 on success
+ */
+rt_err_t mp3_seek_ms(uint32_t ms);
+
 #endif
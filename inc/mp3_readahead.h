@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_READAHEAD_H__
+#define __MP3_READAHEAD_H__
+
+#include <rtthread.h>
+#include "mp3_input.h"
+#include "mp3_file.h"
+
+/*
+ * define MP3_PLAYER_USING_READAHEAD to read the file on a dedicated thread,
+ * otherwise the decoder thread reads the file itself when the input runs low.
+ */
+
+/* bytes per read issued by the read-ahead thread */
+#ifndef MP3_READAHEAD_BLOCK_SIZE
+#define MP3_READAHEAD_BLOCK_SIZE (1024 * 16)
+#endif
+
+/* blocks buffered ahead of the decoder */
+#ifndef MP3_READAHEAD_BLOCKS
+#define MP3_READAHEAD_BLOCKS (2)
+#endif
+
+/*
+ * read-ahead structure definition
+ *
+ * producer of the input ring, the decoder thread is the consumer.
+ */
+struct mp3_readahead
+{
+    struct mp3_input *input;
+    mp3_file_t fp;
+
+    volatile uint8_t running; /* producer may touch fp and input */
+    volatile uint8_t waiting; /* producer sleeps on a full ring */
+    rt_event_t event;
+    rt_thread_t tid;
+
+    /* statistics */
+    volatile uint32_t reads;  /* file reads issued */
+    volatile uint32_t bytes;  /* bytes read */
+    volatile uint32_t stalls; /* decoder found the input empty */
+};
+
+/**
+ * @description: init read-ahead,starts the read-ahead thread if enabled
+ * @param {struct mp3_readahead} *ra
+ * @param {struct mp3_input} *input ring to fill
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_readahead_init(struct mp3_readahead *ra, struct mp3_input *input);
+
+/**
+ * @description: start reading a file from an offset,buffered data is dropped
+ * @param {struct mp3_readahead} *ra
+ * @param {mp3_file_t} fp positioned at offset
+ * @param {uint32_t} offset
+ * @return None
+ */
+void mp3_readahead_start(struct mp3_readahead *ra, mp3_file_t fp, uint32_t offset);
+
+/**
+ * @description: stop reading,the file may be used by the caller after return
+ * @param {struct mp3_readahead} *ra
+ * @return None
+ */
+void mp3_readahead_stop(struct mp3_readahead *ra);
+
+/**
+ * @description: make sure some bytes are buffered,called by the decoder
+ * @param {struct mp3_readahead} *ra
+ * @param {uint32_t} need bytes wanted
+ * @param {rt_int32_t} timeout ticks to wait for the read-ahead thread
+ * @return the error code,0 if need bytes are buffered or input reached end of file
+ */
+rt_err_t mp3_readahead_fill(struct mp3_readahead *ra, uint32_t need, rt_int32_t timeout);
+
+/**
+ * @description: get input fill level
+ * @param {struct mp3_readahead} *ra
+ * @return percent of the input ring filled
+ */
+uint32_t mp3_readahead_level(struct mp3_readahead *ra);
+
+#endif
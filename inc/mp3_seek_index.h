@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_SEEK_INDEX_H__
+#define __MP3_SEEK_INDEX_H__
+
+#include <stdint.h>
+#include "mp3_file.h"
+#include "mp3_frame.h"
+#include <rtthread.h>
+
+/* max index entries, bounds memory to 4 bytes per entry */
+#ifndef MP3_SEEK_INDEX_ENTRIES
+#define MP3_SEEK_INDEX_ENTRIES (2048)
+#endif
+
+/*
+ * seek index structure definition
+ *
+ * entry n holds the file offset of frame n * stride, when all entries are
+ * used every other entry is dropped and the stride doubles, so any file
+ * fits in the same memory.
+ *
+ * the builder and lookups share the entries under lock,a mutex so a
+ * lookup from a higher priority thread lends its priority to the builder
+ * instead of waiting for a thread that can not run.
+ */
+struct mp3_seek_index
+{
+    uint32_t *offset;
+    uint32_t capacity;
+    uint32_t count;           /* valid entries */
+    uint32_t stride;          /* frames between two entries */
+    struct rt_mutex lock;     /* held while entries are added or moved */
+    volatile uint32_t frames;          /* frames walked,false syncs in damaged data are not counted */
+    uint32_t total_samples;   /* samples per channel of the frames walked */
+    uint32_t samplerate;
+    uint16_t samples;         /* samples per frame */
+    uint8_t vbr;              /* bitrate changes between frames */
+    mp3_frame_header_t first; /* later frames must agree with it */
+    volatile uint8_t ready;   /* whole file walked */
+};
+
+/**
+ * @description: init seek index
+ * @param {struct mp3_seek_index} *index
+ * @param {uint32_t} capacity max entries
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek_index_init(struct mp3_seek_index *index, uint32_t capacity);
+
+/**
+ * @description: forget all entries
+ * @param {struct mp3_seek_index} *index
+ * @return None
+ */
+void mp3_seek_index_reset(struct mp3_seek_index *index);
+
+/**
+ * @description: build seek index by walking frame headers
+ * @param {struct mp3_seek_index} *index
+ * @param {mp3_file_t} fp file used only by the caller
+ * @param {uint32_t} data_start file offset of the first frame
+ * @param {uint32_t} data_end file offset where audio data ends
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size
+ * @param {volatile rt_uint8_t} *cancel build stops when it becomes non-zero
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek_index_build(struct mp3_seek_index *index, mp3_file_t fp, uint32_t data_start, uint32_t data_end,
+                              uint8_t *buf, uint32_t size, volatile rt_uint8_t *cancel);
+
+/**
+ * @description: find the nearest indexed frame at or before a frame,
+ *               safe to call while the index is being built
+ * @param {struct mp3_seek_index} *index
+ * @param {uint32_t} frame
+ * @param {uint32_t} *entry_frame indexed frame number
+ * @param {uint32_t} *offset file offset of the indexed frame
+ * @return the error code,0 on success,RT_ERROR if frame is not indexed yet
+ */
+rt_err_t mp3_seek_index_lookup(struct mp3_seek_index *index, uint32_t frame, uint32_t *entry_frame, uint32_t *offset);
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __MP3_STATS_H__
+#define __MP3_STATS_H__
+
+#include <rtthread.h>
+
+/*
+ * define MP3_PLAYER_USING_STATS to count decode,read and write times,
+ * underruns,resyncs and buffer fill levels in the playback path,
+ * without it the counters are compiled out.
+ */
+
+/* buckets of a time histogram,bucket 0 counts 0,bucket n counts [2^(n-1),2^n),the last one the rest */
+#ifndef MP3_STATS_HIST_BUCKETS
+#define MP3_STATS_HIST_BUCKETS (24)
+#endif
+
+/*
+ * times are in cpu cycles if the DWT cycle counter of Cortex-M3/M4/M7/M33
+ * is available,else in ticks.
+ */
+struct mp3_stats_time
+{
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint32_t hist[MP3_STATS_HIST_BUCKETS];
+};
+
+/* fill level of a ring,in percent */
+struct mp3_stats_level
+{
+    uint32_t count;
+    uint32_t min;
+    uint64_t total;
+};
+
+/*
+ * playback statistics since boot or the last reset
+ *
+ * every counter has a single writer thread,a reset that races with it may
+ * leave one sample of the old period behind.
+ */
+struct mp3_player_stats
+{
+    rt_uint8_t cycles;     /* times are in cpu cycles,else in ticks */
+
+    uint32_t frames;       /* frames decoded */
+    uint32_t underruns;    /* pcm ring ran empty while playing */
+    uint32_t resyncs;      /* frame sync lost */
+    uint64_t bytes_read;   /* file bytes read into the input ring */
+
+    struct mp3_stats_time decode; /* MP3Decode of one frame */
+    struct mp3_stats_time write;  /* rt_device_write of one period,blocked while the device queue is full */
+    struct mp3_stats_time read;   /* mp3_file_read of one block */
+
+    struct mp3_stats_level input; /* input ring before each frame */
+    struct mp3_stats_level pcm;   /* pcm ring before each frame,not sampled in zero copy mode */
+};
+
+#ifdef MP3_PLAYER_USING_STATS
+extern struct mp3_player_stats mp3_stats;
+
+#define MP3_STATS_ADD(field, value) (mp3_stats.field += (value))
+#define MP3_STATS_LEVEL(field, percent) mp3_stats_level_add(&mp3_stats.field, (percent))
+/* run statement and add its time to a histogram */
+#define MP3_STATS_TIME(field, statement)                                       \
+    do                                                                         \
+    {                                                                          \
+        rt_uint32_t __stats_start = mp3_stats_clock();                         \
+        statement;                                                             \
+        mp3_stats_time_add(&mp3_stats.field, mp3_stats_clock() - __stats_start); \
+    } while (0)
+#else
+#define MP3_STATS_ADD(field, value) ((void)0)
+#define MP3_STATS_LEVEL(field, percent) ((void)0)
+#define MP3_STATS_TIME(field, statement) \
+    do                                   \
+    {                                    \
+        statement;                       \
+    } while (0)
+#endif
+
+/**
+ * @description: start the DWT cycle counter if the cpu has one
+ * @param None
+ * @return RT_TRUE if mp3_stats_clock counts cpu cycles,else it counts ticks
+ */
+rt_bool_t mp3_stats_clock_init(void);
+
+/**
+ * @description: read the clock of times,wraps around
+ * @param None
+ * @return cpu cycles or ticks
+ */
+rt_uint32_t mp3_stats_clock(void);
+
+/**
+ * @description: add a time to a histogram
+ * @param {struct mp3_stats_time} *time
+ * @param {rt_uint32_t} value
+ * @return None
+ */
+void mp3_stats_time_add(struct mp3_stats_time *time, rt_uint32_t value);
+
+/**
+ * @description: add a fill level
+ * @param {struct mp3_stats_level} *level
+ * @param {uint32_t} percent
+ * @return None
+ */
+void mp3_stats_level_add(struct mp3_stats_level *level, uint32_t percent);
+
+/**
+ * @description: get playback statistics
+ * @param {struct mp3_player_stats} *stats
+ * @return the error code,0 on success,-RT_ENOSYS without MP3_PLAYER_USING_STATS
+ */
+rt_err_t mp3_player_stats_get(struct mp3_player_stats *stats);
+
+/**
+ * @description: clear playback statistics
+ * @param None
+ * @return None
+ */
+void mp3_player_stats_reset(void);
+
+#endif
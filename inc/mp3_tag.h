@@ -51,15 +51,27 @@ typedef struct
     uint16_t flags;
 } ID3V23_FrameHead_t;
 
+#define XING_FLAG_FRAMES (0x01)
+#define XING_FLAG_BYTES (0x02)
+#define XING_FLAG_TOC (0x04)
+#define XING_FLAG_QUALITY (0x08)
+
+/* encoder delay/padding offset in the LAME tag,which follows the Xing fields */
+#define LAME_TAG_DELAY_OFFSET (21)
+
 /* 
  *  MP3 Xing Frame
+ *  fields after flags are only present if their flag is set,
+ *  the layout below is the one with all flags set
  */
 typedef struct
 {
-    uint8_t id[4];
-    uint8_t flags[4];
-    uint8_t frames[4];
-    uint8_t fsize[4];
+    uint8_t id[4];      /* frame id:Xing/Info */
+    uint8_t flags[4];   /* XING_FLAG_xxx */
+    uint8_t frames[4];  /* total frame */
+    uint8_t fsize[4];   /* bytes from the first frame */
+    uint8_t toc[MP3_TOC_SIZE];
+    uint8_t quality[4];
 } MP3_FrameXing_t;
 
 /* 
@@ -73,6 +85,11 @@ typedef struct
     uint8_t quality[2]; /* audio quality，0~100 */
     uint8_t fsize[4];   /* file size */
     uint8_t frames[4];  /* total frame */
+    uint8_t toc_entries[2];      /* seek table entries */
+    uint8_t toc_scale[2];        /* scale factor of table entries */
+    uint8_t toc_entry_size[2];   /* bytes per table entry,1 ~ 4 */
+    uint8_t toc_entry_frames[2]; /* frames covered by one table entry */
+    /* followed by the seek table, big endian byte counts */
 } MP3_FrameVBRI_t;
 
 /**
@@ -82,6 +99,45 @@ typedef struct
  */
 char *mp3_get_genre_string_by_id(uint16_t genre_id);
 
+/**
+ * @description: get data start from the ID3v2 header only,without walking its frames
+ * @param {mp3_file_t} fp
+ * @return {uint32_t} whole tag size,0 if there is no tag
+ */
+uint32_t mp3_tag_data_start(mp3_file_t fp);
+
+/**
+ * @description: parse tags and vbr header of a file,no decoder is needed
+ * @param {mp3_file_t} fp
+ * @param {mp3_info_t} *mp3_info
+ * @param {uint8_t} *buf scratch buffer
+ * @param {uint32_t} size scratch buffer size,no less than 512 bytes
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_info_parse(mp3_file_t fp, mp3_info_t *mp3_info, uint8_t *buf, uint32_t size);
+
+/**
+ * @description: count frames of a file without a Xing/VBRI header by walking frame headers,
+ *               audio is not decoded,a large buffer makes the walk faster
+ * @param {mp3_file_t} fp
+ * @param {mp3_info_t} *mp3_info parsed by mp3_info_parse
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size,no less than 512 bytes
+ * @param {volatile rt_uint8_t} *cancel walk stops when it becomes non-zero,can be RT_NULL
+ * @return the error code,0 on success,-RT_EINTR if cancelled
+ */
+rt_err_t mp3_info_exact(mp3_file_t fp, mp3_info_t *mp3_info, uint8_t *buf, uint32_t size, volatile rt_uint8_t *cancel);
+
+/**
+ * @description: set duration from an exact frame count
+ * @param {mp3_info_t} *mp3_info
+ * @param {uint32_t} frames
+ * @param {uint32_t} samples samples per channel of all frames
+ * @param {uint32_t} samplerate
+ * @return None
+ */
+void mp3_info_exact_set(mp3_info_t *mp3_info, uint32_t frames, uint32_t samples, uint32_t samplerate);
+
 /**
  * @description: get mp3 tag info
  * @param {struct mp3_player} *player
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Date           Author       Notes
+# 2026-10-17     MrzhangF1ghter    first implementation
+#
+"""
+run mp3bench on the corpus and compare the results with a baseline
+
+the corpus is generated by mkcorpus.py when it is missing or stale. the
+results are written as json, and the exit code is 1 when mp3bench failed,
+a file played a wrong number of frames, or a metric regressed against the
+baseline by more than bench_thresholds.json allows.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def corpus_ready(directory, seconds):
+    try:
+        with open(os.path.join(directory, "corpus.json")) as f:
+            manifest = json.load(f)
+    except (OSError, ValueError):
+        return None
+    if manifest.get("seconds") != seconds:
+        return None
+    for entry in manifest["files"]:
+        try:
+            with open(os.path.join(directory, entry["file"]), "rb") as f:
+                if hashlib.sha256(f.read()).hexdigest() != entry["sha256"]:
+                    return None
+        except OSError:
+            return None
+    return manifest
+
+
+def corpus_load(directory, seconds):
+    manifest = corpus_ready(directory, seconds)
+    if manifest is None:
+        print("generating corpus in %s" % directory)
+        subprocess.check_call([sys.executable, os.path.join(HERE, "mkcorpus.py"),
+                               "-d", directory, "-s", str(seconds)])
+        manifest = corpus_ready(directory, seconds)
+    return manifest
+
+
+def metric_value(entry, name, stat):
+    value = entry.get(name)
+    if isinstance(value, dict):
+        value = value.get(stat or "avg")
+    return value
+
+
+def regressed(old, new, rule):
+    """the new value is worse than the rule allows"""
+    slack = rule.get("slack", 0)
+    limit = rule.get("percent", 0) / 100.0
+    if rule.get("better", "lower") == "higher":
+        return new < old * (1 - limit) - slack
+    return new > old * (1 + limit) + slack
+
+
+def compare(result, baseline, thresholds):
+    """print the metrics that moved,return the regressions"""
+    failures = []
+    old_files = {os.path.basename(e["file"]): e for e in baseline["files"]}
+
+    for entry in result["files"]:
+        name = os.path.basename(entry["file"])
+        old = old_files.get(name)
+        if old is None:
+            print("%-32s not in baseline" % name)
+            continue
+        for metric, rule in thresholds["file"].items():
+            a = metric_value(old, metric, rule.get("stat"))
+            b = metric_value(entry, metric, rule.get("stat"))
+            if a is None or b is None:
+                continue
+            bad = regressed(a, b, rule)
+            change = (b - a) * 100.0 / a if a else 0.0
+            print("%-32s %-16s %12.3f -> %12.3f %+7.1f%%%s" % (name, metric, a, b, change, "  REGRESSION" if bad else ""))
+            if bad:
+                failures.append("%s %s" % (name, metric))
+
+    for metric, rule in thresholds["run"].items():
+        a, b = baseline.get(metric), result.get(metric)
+        if a is None or b is None:
+            continue
+        bad = regressed(a, b, rule)
+        print("%-32s %-16s %12d -> %12d%s" % ("(all)", metric, a, b, "  REGRESSION" if bad else ""))
+        if bad:
+            failures.append(metric)
+
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--bench", default=os.path.join(HERE, "build", "mp3bench"), help="mp3bench program")
+    parser.add_argument("--corpus", default=os.path.join(HERE, "corpus"), help="corpus directory")
+    parser.add_argument("--seconds", type=int, default=30, help="length of each corpus file")
+    parser.add_argument("--runs", type=int, default=3, help="plays of every file")
+    parser.add_argument("--seeks", type=int, default=10, help="seeks in every file")
+    parser.add_argument("--output", default="bench.json", help="results file(default bench.json)")
+    parser.add_argument("--baseline", help="results of an earlier run to compare with")
+    parser.add_argument("--thresholds", default=os.path.join(HERE, "bench_thresholds.json"),
+                        help="allowed regression of every metric")
+    args = parser.parse_args()
+
+    manifest = corpus_load(args.corpus, args.seconds)
+    if manifest is None:
+        print("corpus is not usable", file=sys.stderr)
+        return 1
+
+    files = [os.path.join(args.corpus, e["file"]) for e in manifest["files"]]
+    code = subprocess.call([args.bench, "-o", args.output, "-r", str(args.runs), "-k", str(args.seeks)] + files)
+    with open(args.output) as f:
+        result = json.load(f)
+    failures = ["mp3bench exit code %d" % code] if code else []
+
+    # every frame of an undamaged file must be played
+    for entry, expect in zip(result["files"], manifest["files"]):
+        if not expect["file"].startswith("corrupt") and entry["frames"] != expect["frames"]:
+            failures.append("%s played %d of %d frames" % (expect["file"], entry["frames"], expect["frames"]))
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        with open(args.thresholds) as f:
+            thresholds = json.load(f)
+        failures += compare(result, baseline, thresholds)
+
+    for failure in failures:
+        print("FAIL: %s" % failure, file=sys.stderr)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
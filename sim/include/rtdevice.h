@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * RT-Thread device,data queue and audio framework definitions used by
+ * mp3player,for the host simulation build.
+ */
+
+#ifndef __RT_DEVICE_H__
+#define __RT_DEVICE_H__
+
+#include <rtthread.h>
+
+enum rt_device_class_type
+{
+    RT_Device_Class_Char = 0,
+    RT_Device_Class_Block,
+    RT_Device_Class_Sound,
+    RT_Device_Class_Unknown,
+};
+
+#define RT_DEVICE_FLAG_RDONLY 0x001
+#define RT_DEVICE_FLAG_WRONLY 0x002
+#define RT_DEVICE_FLAG_RDWR 0x003
+
+#define RT_DEVICE_OFLAG_CLOSE 0x000
+#define RT_DEVICE_OFLAG_RDONLY 0x001
+#define RT_DEVICE_OFLAG_WRONLY 0x002
+#define RT_DEVICE_OFLAG_RDWR 0x003
+#define RT_DEVICE_OFLAG_OPEN 0x008
+
+/*
+ * device structure definition
+ */
+struct rt_device
+{
+    char name[RT_NAME_MAX];
+    enum rt_device_class_type type;
+    rt_uint16_t flag;
+    rt_uint16_t open_flag;
+    rt_uint8_t ref_count;
+
+    rt_err_t (*init)(struct rt_device *dev);
+    rt_err_t (*open)(struct rt_device *dev, rt_uint16_t oflag);
+    rt_err_t (*close)(struct rt_device *dev);
+    rt_size_t (*read)(struct rt_device *dev, rt_off_t pos, void *buffer, rt_size_t size);
+    rt_size_t (*write)(struct rt_device *dev, rt_off_t pos, const void *buffer, rt_size_t size);
+    rt_err_t (*control)(struct rt_device *dev, int cmd, void *args);
+
+    void *user_data;
+    struct rt_device *next; /* device list of the shim */
+};
+typedef struct rt_device *rt_device_t;
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags);
+rt_device_t rt_device_find(const char *name);
+rt_err_t rt_device_open(rt_device_t dev, rt_uint16_t oflag);
+rt_err_t rt_device_close(rt_device_t dev);
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size);
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size);
+rt_err_t rt_device_control(rt_device_t dev, int cmd, void *arg);
+
+/*
+ * data queue
+ */
+struct rt_data_item
+{
+    const void *data_ptr;
+    rt_size_t data_size;
+};
+
+struct rt_data_queue
+{
+    rt_uint16_t size;
+    rt_uint16_t lwm;
+    rt_uint16_t get_index;
+    rt_uint16_t put_index;
+    rt_uint16_t count;
+    struct rt_data_item *queue;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+rt_err_t rt_data_queue_init(struct rt_data_queue *queue, rt_uint16_t size, rt_uint16_t lwm,
+                            void (*evt_notify)(struct rt_data_queue *queue, rt_uint32_t event));
+rt_err_t rt_data_queue_push(struct rt_data_queue *queue, const void *data_ptr, rt_size_t data_size, rt_int32_t timeout);
+rt_err_t rt_data_queue_pop(struct rt_data_queue *queue, const void **data_ptr, rt_size_t *size, rt_int32_t timeout);
+rt_err_t rt_data_queue_peek(struct rt_data_queue *queue, const void **data_ptr, rt_size_t *size);
+rt_uint16_t rt_data_queue_len(struct rt_data_queue *queue);
+
+/*
+ * audio framework
+ */
+#define AUDIO_TYPE_QUERY 0x00
+#define AUDIO_TYPE_INPUT 0x01
+#define AUDIO_TYPE_OUTPUT 0x02
+#define AUDIO_TYPE_MIXER 0x04
+
+#define AUDIO_DSP_PARAM 0
+#define AUDIO_DSP_SAMPLERATE 1
+#define AUDIO_DSP_CHANNELS 2
+#define AUDIO_DSP_SAMPLEBITS 3
+
+#define AUDIO_MIXER_QUERY 0x0000
+#define AUDIO_MIXER_MUTE 0x0001
+#define AUDIO_MIXER_VOLUME 0x0002
+
+#define AUDIO_CTL_GETCAPS 0x41
+#define AUDIO_CTL_CONFIGURE 0x42
+
+struct rt_audio_configure
+{
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_uint16_t samplebits;
+};
+
+struct rt_audio_caps
+{
+    int main_type;
+    int sub_type;
+
+    union
+    {
+        rt_uint32_t mask;
+        int value;
+        struct rt_audio_configure config;
+    } udata;
+};
+
+struct rt_audio_buf_info
+{
+    rt_uint8_t *buffer;
+    rt_uint16_t block_size;
+    rt_uint16_t block_count;
+    rt_uint32_t total_size;
+};
+
+struct rt_audio_replay
+{
+    struct rt_mempool *mp;
+    struct rt_data_queue queue;
+    struct rt_mutex lock;
+    struct rt_completion cmp;
+    struct rt_audio_buf_info buf_info;
+    rt_uint8_t *write_data;
+    rt_uint16_t write_index;
+    rt_uint16_t read_index;
+    rt_uint32_t pos;
+    rt_uint8_t event;
+    rt_bool_t activated;
+};
+
+struct rt_audio_ops;
+
+struct rt_audio_device
+{
+    struct rt_device parent;
+    struct rt_audio_ops *ops;
+    struct rt_audio_replay *replay;
+    void *record;
+};
+
+#endif
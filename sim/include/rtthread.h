@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * RT-Thread kernel API used by mp3player,implemented on POSIX threads
+ * for the host simulation build,see rtthread_posix.c.
+ */
+
+#ifndef __RT_THREAD_H__
+#define __RT_THREAD_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include <rtconfig.h>
+
+#define RT_VERSION 4
+#define RT_SUBVERSION 1
+#define RT_REVISION 1
+#define RT_VER_NUM 0x40101
+
+typedef int rt_bool_t;
+typedef long rt_base_t;
+typedef unsigned long rt_ubase_t;
+typedef int8_t rt_int8_t;
+typedef int16_t rt_int16_t;
+typedef int32_t rt_int32_t;
+typedef int64_t rt_int64_t;
+typedef uint8_t rt_uint8_t;
+typedef uint16_t rt_uint16_t;
+typedef uint32_t rt_uint32_t;
+typedef uint64_t rt_uint64_t;
+typedef rt_base_t rt_err_t;
+typedef rt_uint32_t rt_tick_t;
+typedef rt_ubase_t rt_size_t;
+typedef rt_base_t rt_ssize_t;
+typedef rt_base_t rt_off_t;
+
+#define RT_TRUE 1
+#define RT_FALSE 0
+#define RT_NULL ((void *)0)
+
+#define RT_EOK 0
+#define RT_ERROR 1
+#define RT_ETIMEOUT 2
+#define RT_EFULL 3
+#define RT_EEMPTY 4
+#define RT_ENOMEM 5
+#define RT_ENOSYS 6
+#define RT_EBUSY 7
+#define RT_EIO 8
+#define RT_EINTR 9
+#define RT_EINVAL 10
+
+#define RT_WAITING_FOREVER -1
+#define RT_WAITING_NO 0
+
+#define RT_IPC_FLAG_FIFO 0x00
+#define RT_IPC_FLAG_PRIO 0x01
+
+#define RT_EVENT_FLAG_AND 0x01
+#define RT_EVENT_FLAG_OR 0x02
+#define RT_EVENT_FLAG_CLEAR 0x04
+
+#define RT_NAME_MAX 8
+
+#define RT_ALIGN(size, align) (((size) + (align) - 1) & ~((align) - 1))
+#define RT_ALIGN_DOWN(size, align) ((size) & ~((align) - 1))
+
+#define RT_ASSERT(EX)
+#define RT_UNUSED(x) ((void)(x))
+
+/*
+ * ipc objects,the fields are private to the shim
+ */
+struct rt_mutex
+{
+    char name[RT_NAME_MAX];
+    pthread_mutex_t lock;
+};
+typedef struct rt_mutex *rt_mutex_t;
+
+struct rt_event
+{
+    char name[RT_NAME_MAX];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    rt_uint32_t set;
+};
+typedef struct rt_event *rt_event_t;
+
+struct rt_messagequeue
+{
+    char name[RT_NAME_MAX];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    rt_uint8_t *pool;
+    rt_size_t msg_size;
+    rt_size_t max_msgs;
+    rt_size_t entry;
+    rt_size_t head;
+};
+typedef struct rt_messagequeue *rt_mq_t;
+
+struct rt_completion
+{
+    volatile rt_uint32_t flag;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+struct rt_thread
+{
+    char name[RT_NAME_MAX];
+    pthread_t tid;
+    void (*entry)(void *parameter);
+    void *parameter;
+    void *stack_addr; /* '#' filled,never used by the host thread */
+    rt_uint32_t stack_size;
+    rt_uint8_t current_priority;
+};
+typedef struct rt_thread *rt_thread_t;
+
+typedef int (*init_fn_t)(void);
+
+/* initialization functions are collected in a section and run by rt_components_init */
+#define INIT_APP_EXPORT(fn) \
+    static const init_fn_t __rt_init_##fn __attribute__((used, section("rti_fn"))) = fn
+
+/* finsh is not simulated */
+#define MSH_CMD_EXPORT(command, desc)
+#define MSH_CMD_EXPORT_ALIAS(command, alias, desc)
+
+/* kernel */
+void rt_components_init(void);
+rt_tick_t rt_tick_get(void);
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms);
+void rt_enter_critical(void);
+void rt_exit_critical(void);
+rt_base_t rt_hw_interrupt_disable(void);
+void rt_hw_interrupt_enable(rt_base_t level);
+
+/* thread */
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick);
+rt_err_t rt_thread_startup(rt_thread_t thread);
+rt_thread_t rt_thread_self(void);
+rt_err_t rt_thread_yield(void);
+rt_err_t rt_thread_delay(rt_tick_t tick);
+rt_err_t rt_thread_mdelay(rt_int32_t ms);
+
+/* mutex */
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag);
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag);
+rt_err_t rt_mutex_delete(rt_mutex_t mutex);
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time);
+rt_err_t rt_mutex_release(rt_mutex_t mutex);
+
+/* event */
+rt_event_t rt_event_create(const char *name, rt_uint8_t flag);
+rt_err_t rt_event_delete(rt_event_t event);
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set);
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt, rt_int32_t timeout, rt_uint32_t *recved);
+
+/* message queue */
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag);
+rt_err_t rt_mq_delete(rt_mq_t mq);
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size);
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout);
+
+/* completion */
+void rt_completion_init(struct rt_completion *completion);
+rt_err_t rt_completion_wait(struct rt_completion *completion, rt_int32_t timeout);
+void rt_completion_done(struct rt_completion *completion);
+
+/* memory,usage is tracked like the RT-Thread heap */
+void *rt_malloc(rt_size_t size);
+void *rt_realloc(void *rmem, rt_size_t newsize);
+void *rt_calloc(rt_size_t count, rt_size_t size);
+void rt_free(void *rmem);
+char *rt_strdup(const char *s);
+void rt_memory_info(rt_size_t *total, rt_size_t *used, rt_size_t *max_used);
+
+/* memory pool,zero copy output is not simulated */
+struct rt_mempool
+{
+    rt_size_t block_size;
+};
+typedef struct rt_mempool *rt_mp_t;
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time);
+void rt_mp_free(void *block);
+
+/* console */
+int rt_kprintf(const char *fmt, ...);
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...);
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * ulog macros for the host simulation build,output goes to stderr
+ */
+
+#ifndef __ULOG_H__
+#define __ULOG_H__
+
+#include <rtthread.h>
+
+#define DBG_ERROR 3
+#define DBG_WARNING 4
+#define DBG_INFO 6
+#define DBG_LOG 7
+
+#ifndef LOG_TAG
+#define LOG_TAG "NO_TAG"
+#endif
+
+#ifndef LOG_LVL
+#define LOG_LVL DBG_WARNING
+#endif
+
+void ulog_output(rt_uint32_t level, const char *tag, const char *format, ...);
+void ulog_global_filter_lvl_set(rt_uint32_t level);
+
+#if (LOG_LVL >= DBG_ERROR)
+#define LOG_E(...) ulog_output(DBG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#define LOG_E(...)
+#endif
+
+#if (LOG_LVL >= DBG_WARNING)
+#define LOG_W(...) ulog_output(DBG_WARNING, LOG_TAG, __VA_ARGS__)
+#else
+#define LOG_W(...)
+#endif
+
+#if (LOG_LVL >= DBG_INFO)
+#define LOG_I(...) ulog_output(DBG_INFO, LOG_TAG, __VA_ARGS__)
+#else
+#define LOG_I(...)
+#endif
+
+#if (LOG_LVL >= DBG_LOG)
+#define LOG_D(...) ulog_output(DBG_LOG, LOG_TAG, __VA_ARGS__)
+#else
+#define LOG_D(...)
+#endif
+
+#endif
@@ -0,0 +1,355 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Date           Author       Notes
+# 2026-10-17     MrzhangF1ghter    first implementation
+#
+"""
+generate the mp3 benchmark corpus
+
+every file is built from a fixed seed without an encoder: layer III frames
+with zero scalefactors whose spectrum is coded in the big values region
+(table 1) and the count1 region (table B), filled up to the frame's bit
+budget. the decoder runs huffman decode, dequantization, imdct and the
+polyphase filterbank on every granule like for real music, and the same
+seed gives the same bytes on every host.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import random
+import struct
+import sys
+
+CORPUS_VERSION = 1
+
+BITRATES = {
+    1: [0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320],
+    2: [0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160],
+}
+SAMPLERATES = {
+    1: [44100, 48000, 32000],
+    2: [22050, 24000, 16000],
+}
+
+# huffman table 1,(x,y) -> (code,length)
+HUFF_TABLE1 = {(0, 0): (0b1, 1), (0, 1): (0b001, 3), (1, 0): (0b01, 2), (1, 1): (0b000, 3)}
+GLOBAL_GAIN = 180
+
+
+class BitWriter:
+    def __init__(self):
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value, bits):
+        self.acc = (self.acc << bits) | (value & ((1 << bits) - 1))
+        self.bits += bits
+
+    def tobytes(self, size):
+        """pad with zero bits to size bytes"""
+        pad = size * 8 - self.bits
+        if pad < 0:
+            raise ValueError("%d bits do not fit in %d bytes" % (self.bits, size))
+        return (self.acc << pad).to_bytes(size, "big")
+
+
+class Stream:
+    """one mpeg audio layer III stream"""
+
+    def __init__(self, samplerate, channels, seed):
+        self.version = 1 if samplerate >= 32000 else 2
+        self.samplerate = samplerate
+        self.channels = channels
+        self.granules = 2 if self.version == 1 else 1
+        if self.version == 1:
+            self.side_size = 32 if channels == 2 else 17
+        else:
+            self.side_size = 17 if channels == 2 else 9
+        self.rng = random.Random(seed)
+        self.pad_acc = 0
+
+    @property
+    def samples_per_frame(self):
+        return 576 * self.granules
+
+    def header(self, bitrate, padding):
+        index = BITRATES[self.version].index(bitrate)
+        bw = BitWriter()
+        bw.put(0x7FF, 11)
+        bw.put(3 if self.version == 1 else 2, 2)
+        bw.put(1, 2)  # layer III
+        bw.put(1, 1)  # no crc
+        bw.put(index, 4)
+        bw.put(SAMPLERATES[self.version].index(self.samplerate), 2)
+        bw.put(padding, 1)
+        bw.put(0, 1)
+        bw.put(3 if self.channels == 1 else 0, 2)
+        bw.put(0, 2)
+        bw.put(0, 1)
+        bw.put(1, 1)
+        bw.put(0, 2)
+        return bw.tobytes(4)
+
+    def frame_size(self, bitrate):
+        """size of the next frame,padding spreads the fraction like an encoder"""
+        coef = 144000 if self.version == 1 else 72000
+        size, frac = divmod(coef * bitrate, self.samplerate)
+        self.pad_acc += frac
+        padding = 0
+        if self.pad_acc >= self.samplerate:
+            self.pad_acc -= self.samplerate
+            padding = 1
+        return size + padding, padding
+
+    def spectrum_value(self, line, density):
+        """-1,0 or 1,denser in low frequencies"""
+        r = self.rng.random()
+        p = density * (1.0 - line / 720.0)
+        if r >= p:
+            return 0
+        return -1 if r < p / 2 else 1
+
+    def encode_granule(self, bw, budget, density):
+        """code one granule of one channel into bw,return (part2_3_length,big_values)"""
+        start = bw.bits
+        line = 0
+
+        # big values region,pairs of table 1,up to half of the budget
+        big_values = 0
+        while line < 288 and bw.bits - start < budget // 2:
+            x = self.spectrum_value(line, density)
+            y = self.spectrum_value(line + 1, density)
+            code, length = HUFF_TABLE1[(abs(x), abs(y))]
+            bw.put(code, length)
+            for v in (x, y):
+                if v:
+                    bw.put(1 if v < 0 else 0, 1)
+            line += 2
+            big_values += 1
+
+        # count1 region,quadruples of table B while they fit
+        while line + 4 <= 576:
+            quad = [self.spectrum_value(line + i, density) for i in range(4)]
+            signs = [1 if v < 0 else 0 for v in quad if v]
+            if bw.bits - start + 4 + len(signs) > budget:
+                break
+            vwxy = (abs(quad[0]) << 3) | (abs(quad[1]) << 2) | (abs(quad[2]) << 1) | abs(quad[3])
+            bw.put(15 - vwxy, 4)
+            for s in signs:
+                bw.put(s, 1)
+            line += 4
+
+        return bw.bits - start, big_values
+
+    def frame(self, bitrate, density=0.5, silent=False):
+        size, padding = self.frame_size(bitrate)
+        main_bits = (size - 4 - self.side_size) * 8
+        budget = main_bits // (self.granules * self.channels)
+
+        main = BitWriter()
+        granules = []
+        for gr in range(self.granules):
+            for ch in range(self.channels):
+                if silent:
+                    granules.append((0, 0))
+                else:
+                    granules.append(self.encode_granule(main, budget, density))
+
+        side = BitWriter()
+        if self.version == 1:
+            side.put(0, 9)  # main_data_begin,no bit reservoir
+            side.put(0, 5 if self.channels == 1 else 3)
+            for ch in range(self.channels):
+                side.put(0, 4)  # scfsi
+        else:
+            side.put(0, 8)
+            side.put(0, 1 if self.channels == 1 else 2)
+        for part2_3_length, big_values in granules:
+            side.put(part2_3_length, 12)
+            side.put(big_values, 9)
+            side.put(GLOBAL_GAIN if part2_3_length else 0, 8)
+            side.put(0, 4 if self.version == 1 else 9)  # scalefac_compress,no scalefactors
+            side.put(0, 1)  # window_switching_flag
+            for i in range(3):
+                side.put(1, 5)  # table_select
+            side.put(7, 4)  # region0_count
+            side.put(7, 3)  # region1_count
+            if self.version == 1:
+                side.put(0, 1)  # preflag
+            side.put(0, 1)  # scalefac_scale
+            side.put(1, 1)  # count1table_select,table B
+
+        return self.header(bitrate, padding) + side.tobytes(self.side_size) + main.tobytes(size - 4 - self.side_size)
+
+    def xing_frame(self, frames, sizes):
+        """empty frame carrying frames,bytes and toc,like LAME writes it"""
+        bitrate = 64
+        data = bytearray(self.frame(bitrate, silent=True))
+        total = len(data) + sum(sizes)
+        offsets = [len(data)]
+        for s in sizes[:-1]:
+            offsets.append(offsets[-1] + s)
+        toc = bytes(min(255, offsets[min(frames - 1, i * frames // 100)] * 256 // total) for i in range(100))
+        xing = b"Xing" + struct.pack(">III", 0x07, frames, total) + toc
+        pos = 4 + self.side_size
+        data[pos:pos + len(xing)] = xing
+        return bytes(data)
+
+
+def frame_count(samplerate, seconds):
+    return seconds * samplerate // (1152 if samplerate >= 32000 else 576)
+
+
+def cbr(samplerate, channels, bitrate, seconds, seed):
+    st = Stream(samplerate, channels, seed)
+    frames = [st.frame(bitrate) for _ in range(frame_count(samplerate, seconds))]
+    return b"".join(frames), len(frames)
+
+
+def vbr(samplerate, channels, seconds, seed):
+    st = Stream(samplerate, channels, seed)
+    table = BITRATES[st.version]
+    low, high = (6, 13) if st.version == 1 else (4, 11)
+    n = frame_count(samplerate, seconds)
+    frames = []
+    for i in range(n):
+        # a slow triangle over the allowed bitrates,with jitter
+        phase = (i * 2 * (high - low) // 97) % (2 * (high - low))
+        level = low + (phase if phase <= high - low else 2 * (high - low) - phase)
+        level = max(low, min(high, level + int(st.rng.random() * 3) - 1))
+        frames.append(st.frame(table[level], density=0.3 + 0.05 * (level - low)))
+    st.pad_acc = 0
+    xing = st.xing_frame(n, [len(f) for f in frames])
+    return xing + b"".join(frames), n
+
+
+def id3v2_frame(fid, payload):
+    return fid.encode() + struct.pack(">IH", len(payload), 0) + payload
+
+
+def id3v2_tag(picture_size, seed):
+    rng = random.Random(seed)
+    # jpeg markers and entropy coded bytes,0xff bytes give false frame syncs
+    picture = bytearray(b"\xff\xd8\xff\xe0\x00\x10JFIF\x00")
+    while len(picture) < picture_size:
+        picture.append(int(rng.random() * 256))
+    picture += b"\xff\xd9"
+    body = b"".join([
+        id3v2_frame("TIT2", b"\x00Benchmark Tone"),
+        id3v2_frame("TPE1", b"\x00mp3player"),
+        id3v2_frame("TALB", b"\x00Corpus"),
+        id3v2_frame("TYER", b"\x002026"),
+        id3v2_frame("COMM", b"\x00eng\x00" + b"large tag with album art " * 8),
+        id3v2_frame("APIC", b"\x00image/jpeg\x00\x03cover\x00" + bytes(picture)),
+    ]) + bytes(4096)  # padding
+    size = len(body)
+    syncsafe = bytes([(size >> 21) & 0x7F, (size >> 14) & 0x7F, (size >> 7) & 0x7F, size & 0x7F])
+    return b"ID3\x03\x00\x00" + syncsafe + body
+
+
+def id3v1_tag():
+    def field(text, size):
+        return text.encode().ljust(size, b"\x00")
+    return b"TAG" + field("Benchmark Tone", 30) + field("mp3player", 30) + field("Corpus", 30) + \
+        field("2026", 4) + field("", 30) + bytes([0])
+
+
+def corrupt(data, frames, samplerate, bitrate, seed):
+    """damage a cbr stream at fixed places,return the damaged stream"""
+    rng = random.Random(seed)
+    # frame sizes follow the padding pattern of cbr()
+    st = Stream(samplerate, 2, 0)
+    offsets = [0]
+    for _ in range(frames):
+        offsets.append(offsets[-1] + st.frame_size(bitrate)[0])
+
+    def noise(n):
+        return bytes(int(rng.random() * 256) for _ in range(n))
+
+    def false_syncs(n):
+        out = bytearray(noise(n))
+        for pos in range(17, n - 4, 301):
+            out[pos:pos + 4] = b"\xff\xfb\x90\x00"
+        return bytes(out)
+
+    out = bytearray()
+    for i in range(frames):
+        frame = bytearray(data[offsets[i]:offsets[i + 1]])
+        if i == frames * 10 // 100:
+            frame[40:88] = noise(48)                  # bad main data
+        elif i == frames * 25 // 100:
+            frame[0:4] = noise(4)                     # lost header
+        elif i == frames * 40 // 100:
+            out += false_syncs(4096)                  # garbage with false syncs
+        elif i == frames * 60 // 100:
+            out += bytes(2048)                        # zeroed sectors
+            continue
+        elif i == frames * 75 // 100:
+            frame = frame[:len(frame) // 2]           # short frame
+        elif i == frames - 1:
+            frame = frame[:len(frame) // 2]           # truncated file
+        out += frame
+    return bytes(out)
+
+
+def corpus(seconds):
+    """(name,samplerate,channels,vbr,builder)"""
+    return [
+        ("cbr_44k_stereo_128.mp3", 44100, 2, False, lambda: cbr(44100, 2, 128, seconds, 1)),
+        ("cbr_48k_stereo_320.mp3", 48000, 2, False, lambda: cbr(48000, 2, 320, seconds, 2)),
+        ("cbr_44k_mono_64.mp3", 44100, 1, False, lambda: cbr(44100, 1, 64, seconds, 3)),
+        ("cbr_22k_stereo_64.mp3", 22050, 2, False, lambda: cbr(22050, 2, 64, seconds, 4)),
+        ("cbr_22k_mono_32.mp3", 22050, 1, False, lambda: cbr(22050, 1, 32, seconds, 5)),
+        ("vbr_44k_stereo.mp3", 44100, 2, True, lambda: vbr(44100, 2, seconds, 6)),
+        ("vbr_48k_mono.mp3", 48000, 1, True, lambda: vbr(48000, 1, seconds, 7)),
+        ("vbr_22k_stereo.mp3", 22050, 2, True, lambda: vbr(22050, 2, seconds, 8)),
+        ("id3_large_44k_stereo_128.mp3", 44100, 2, False, lambda: tagged(seconds)),
+        ("corrupt_44k_stereo_128.mp3", 44100, 2, False, lambda: damaged(seconds)),
+    ]
+
+
+def tagged(seconds):
+    data, frames = cbr(44100, 2, 128, seconds, 9)
+    return id3v2_tag(256 * 1024, 9) + data + id3v1_tag(), frames
+
+
+def damaged(seconds):
+    data, frames = cbr(44100, 2, 128, seconds, 10)
+    return corrupt(data, frames, 44100, 128, 10), frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("-d", "--dir", default="corpus", help="output directory(default corpus)")
+    parser.add_argument("-s", "--seconds", type=int, default=30, help="length of each file(default 30)")
+    args = parser.parse_args()
+
+    os.makedirs(args.dir, exist_ok=True)
+    manifest = {"version": CORPUS_VERSION, "seconds": args.seconds, "files": []}
+    for name, samplerate, channels, is_vbr, build in corpus(args.seconds):
+        data, frames = build()
+        with open(os.path.join(args.dir, name), "wb") as f:
+            f.write(data)
+        manifest["files"].append({
+            "file": name,
+            "samplerate": samplerate,
+            "channels": channels,
+            "vbr": is_vbr,
+            "frames": frames,
+            "bytes": len(data),
+            "sha256": hashlib.sha256(data).hexdigest(),
+        })
+        print("%-32s %6d frames %8d bytes" % (name, frames, len(data)))
+
+    with open(os.path.join(args.dir, "corpus.json"), "w") as f:
+        json.dump(manifest, f, indent=2)
+        f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,383 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * mp3bench,measures mp3player on the host
+ *
+ * for every file:
+ *   info  - mp3_get_info on the opened file
+ *   play  - mp3_player_play to the first pcm write,and frames decoded per
+ *           second with the sound device running as fast as possible
+ *   seek  - mp3_seek_ms until the first sample of the target position has
+ *           been played,with the sound device running in real time
+ * the results are written to a json file,bench.py compares them with a
+ * baseline.
+ */
+
+#include <rtthread.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "mp3_player.h"
+#include "mp3_tag.h"
+#include "sim_sound.h"
+
+#define BENCH_POLL_US (100)
+#define BENCH_TIMEOUT_MS (5000)        /* a play or seek that takes longer has failed */
+#define BENCH_SEEK_SETTLE_MS (200)     /* played before the first seek */
+#define BENCH_SEEK_WINDOW_MS (1000)    /* a position in [target,target + window) is the target */
+
+struct bench_stat
+{
+    double min;
+    double max;
+    double sum;
+    uint32_t count;
+};
+
+struct bench_result
+{
+    uint32_t frames;
+    uint32_t samplerate;
+    double seconds;             /* played */
+    double decode_fps;          /* best run */
+    double realtime;            /* played seconds per second,best run */
+    struct bench_stat first_write_ms;
+    struct bench_stat info_us;
+    struct bench_stat seek_ms;
+    uint32_t seek_timeouts;
+    uint32_t resyncs;
+    uint32_t resync_bytes;
+};
+
+static struct mp3_player bench_player;
+static uint8_t bench_buffer[MP3_INPUT_BUFFER_SIZE];
+
+static double bench_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void bench_stat_add(struct bench_stat *stat, double value)
+{
+    if (stat->count == 0 || value < stat->min)
+        stat->min = value;
+    if (stat->count == 0 || value > stat->max)
+        stat->max = value;
+    stat->sum += value;
+    stat->count++;
+}
+
+static void bench_stat_print(FILE *fp, const char *name, const struct bench_stat *stat)
+{
+    if (stat->count == 0)
+    {
+        fprintf(fp, "      \"%s\": null,\n", name);
+        return;
+    }
+    fprintf(fp, "      \"%s\": {\"min\": %.3f, \"avg\": %.3f, \"max\": %.3f},\n",
+            name, stat->min, stat->sum / stat->count, stat->max);
+}
+
+/**
+ * @description: wait until the player has stopped
+ * @param None
+ * @return the error code,0 on success
+ */
+static rt_err_t bench_wait_stopped(void)
+{
+    double start = bench_now_ms();
+
+    while (mp3_player_state_get() != PLAYER_STATE_STOPED)
+    {
+        if (bench_now_ms() - start > BENCH_TIMEOUT_MS * 10)
+            return -RT_ETIMEOUT;
+        usleep(BENCH_POLL_US);
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @description: time mp3_get_info on the opened file
+ * @param {const char} *path
+ * @param {struct bench_result} *result
+ * @return the error code,0 on success
+ */
+static rt_err_t bench_info(const char *path, struct bench_result *result)
+{
+    struct mp3_player *player = &bench_player;
+    double start;
+    rt_err_t ret;
+
+    player->uri = (char *)path;
+    player->in_buffer = bench_buffer;
+    player->fp = mp3_file_open(path);
+    if (player->fp == MP3_FILE_NULL)
+        return -RT_ERROR;
+
+    start = bench_now_ms();
+    ret = mp3_get_info(player);
+    bench_stat_add(&result->info_us, (bench_now_ms() - start) * 1000);
+    mp3_file_close(player->fp);
+    player->fp = MP3_FILE_NULL;
+
+    result->samplerate = player->mp3_info.samplerate;
+
+    return ret;
+}
+
+/**
+ * @description: play a file as fast as possible
+ * @param {const char} *path
+ * @param {struct bench_result} *result
+ * @return the error code,0 on success
+ */
+static rt_err_t bench_play(const char *path, struct bench_result *result)
+{
+    struct sim_sound_stats before, after;
+    uint32_t samples, frame_samples;
+    double start, elapsed;
+
+    sim_sound_speed_set(0);
+    sim_sound_stats_get(&before);
+    sim_sound_mark();
+
+    start = bench_now_ms();
+    mp3_player_play((char *)path);
+    if (bench_wait_stopped() != RT_EOK)
+        return -RT_ETIMEOUT;
+    elapsed = bench_now_ms() - start;
+    sim_sound_drain();
+    sim_sound_stats_get(&after);
+
+    samples = (after.bytes - before.bytes) / 4;
+    if (samples == 0 || after.first_write_ns == 0 || after.samplerate == 0)
+        return -RT_ERROR;
+
+    /* layer III frames of mpeg 2 and 2.5 have one granule */
+    frame_samples = after.samplerate >= 32000 ? 1152 : 576;
+    result->frames = samples / frame_samples;
+    result->seconds = (double)samples / after.samplerate;
+    bench_stat_add(&result->first_write_ms, after.first_write_ns / 1000000.0 - start);
+    if (result->frames / elapsed * 1000 > result->decode_fps)
+    {
+        result->decode_fps = result->frames / elapsed * 1000;
+        result->realtime = result->seconds / elapsed * 1000;
+    }
+    mp3_player_resync_get(&result->resyncs, &result->resync_bytes);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: seek around a file played in real time
+ * @param {const char} *path
+ * @param {uint32_t} seeks
+ * @param {struct bench_result} *result
+ * @return the error code,0 on success
+ */
+static rt_err_t bench_seek(const char *path, uint32_t seeks, struct bench_result *result)
+{
+    uint32_t span, target, position, i;
+    double start;
+    rt_err_t ret = RT_EOK;
+
+    /* keep clear of the end,the track must not finish during a seek */
+    span = result->seconds * 1000;
+    if (span < 4000)
+        return RT_EOK;
+    span -= 3000;
+
+    sim_sound_speed_set(100);
+    mp3_player_play((char *)path);
+    start = bench_now_ms();
+    while (mp3_player_position_ms() < BENCH_SEEK_SETTLE_MS)
+    {
+        if (bench_now_ms() - start > BENCH_TIMEOUT_MS)
+        {
+            ret = -RT_ETIMEOUT;
+            goto __exit;
+        }
+        usleep(BENCH_POLL_US);
+    }
+
+    for (i = 0; i < seeks; i++)
+    {
+        /* 30%,0%,70%,40%... every jump is at least 30% of the span */
+        target = (uint64_t)span * ((i * 7 + 3) % 10) / 10;
+        start = bench_now_ms();
+        mp3_seek_ms(target);
+        while (1)
+        {
+            position = mp3_player_position_ms();
+            if (position > target && position < target + BENCH_SEEK_WINDOW_MS)
+            {
+                bench_stat_add(&result->seek_ms, bench_now_ms() - start);
+                break;
+            }
+            if (bench_now_ms() - start > BENCH_TIMEOUT_MS)
+            {
+                result->seek_timeouts++;
+                break;
+            }
+            usleep(BENCH_POLL_US);
+        }
+    }
+
+__exit:
+    mp3_player_stop();
+    sim_sound_drain();
+    sim_sound_speed_set(0);
+
+    return ret;
+}
+
+static void bench_json_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', fp);
+        fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [option] -o FILE file ...\n"
+            "  -o FILE   write the results to FILE as json\n"
+            "  -r RUNS   plays of every file(default 3)\n"
+            "  -k SEEKS  seeks in every file,0 to skip(default 10)\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_result *results;
+    const char *output = RT_NULL;
+    FILE *console;
+    uint32_t runs = 3, seeks = 10, run;
+    rt_size_t total, used, max_used;
+    double start;
+    FILE *fp;
+    int failed = 0;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "o:r:k:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o':
+            output = optarg;
+            break;
+        case 'r':
+            runs = strtoul(optarg, RT_NULL, 0);
+            break;
+        case 'k':
+            seeks = strtoul(optarg, RT_NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (output == RT_NULL || optind >= argc || runs == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    results = calloc(argc - optind, sizeof(struct bench_result));
+    if (results == RT_NULL)
+        return 1;
+
+    /* the player prints the mp3 info of every play to the console */
+    console = fdopen(dup(STDOUT_FILENO), "w");
+    if (console == RT_NULL || freopen("/dev/null", "w", stdout) == RT_NULL)
+        return 1;
+
+    ulog_global_filter_lvl_set(DBG_WARNING);
+    if (sim_sound_register(MP3_SOUND_DEVICE_NAME, RT_NULL, 0) != RT_EOK)
+        return 1;
+    rt_components_init();
+    start = bench_now_ms();
+    while (mp3_player_volume_get() != MP3_PLAYER_VOLUME_DEFAULT)
+    {
+        if (bench_now_ms() - start > BENCH_TIMEOUT_MS)
+        {
+            fprintf(stderr, "mp3 player did not start\n");
+            return 1;
+        }
+        usleep(BENCH_POLL_US);
+    }
+
+    for (i = optind; i < argc; i++)
+    {
+        struct bench_result *result = &results[i - optind];
+
+        for (run = 0; run < runs; run++)
+        {
+            if (bench_info(argv[i], result) != RT_EOK || bench_play(argv[i], result) != RT_EOK)
+            {
+                fprintf(stderr, "%s: play failed\n", argv[i]);
+                failed = 1;
+                break;
+            }
+        }
+        if (run == runs && seeks > 0 && bench_seek(argv[i], seeks, result) != RT_EOK)
+        {
+            fprintf(stderr, "%s: seek failed\n", argv[i]);
+            failed = 1;
+        }
+    }
+
+    fp = fopen(output, "w");
+    if (fp == RT_NULL)
+    {
+        fprintf(stderr, "can not open %s\n", output);
+        return 1;
+    }
+    rt_memory_info(&total, &used, &max_used);
+    fprintf(fp, "{\n  \"runs\": %u,\n  \"seeks\": %u,\n  \"heap_peak\": %u,\n  \"files\": [\n",
+            runs, seeks, (unsigned)max_used);
+    for (i = optind; i < argc; i++)
+    {
+        struct bench_result *result = &results[i - optind];
+
+        fprintf(fp, "    {\n      \"file\": ");
+        bench_json_string(fp, argv[i]);
+        fprintf(fp, ",\n      \"samplerate\": %u,\n      \"frames\": %u,\n      \"seconds\": %.3f,\n",
+                result->samplerate, result->frames, result->seconds);
+        fprintf(fp, "      \"decode_fps\": %.1f,\n      \"realtime\": %.1f,\n", result->decode_fps, result->realtime);
+        bench_stat_print(fp, "first_write_ms", &result->first_write_ms);
+        bench_stat_print(fp, "info_us", &result->info_us);
+        bench_stat_print(fp, "seek_ms", &result->seek_ms);
+        fprintf(fp, "      \"seek_timeouts\": %u,\n      \"resyncs\": %u,\n      \"resync_bytes\": %u\n    }%s\n",
+                result->seek_timeouts, result->resyncs, result->resync_bytes, i + 1 < argc ? "," : "");
+
+        fprintf(console, "%-40s %8.0f frames/s %7.1fx  first write %6.2f ms  info %7.1f us  seek %6.2f ms\n",
+               argv[i], result->decode_fps, result->realtime,
+               result->first_write_ms.count ? result->first_write_ms.sum / result->first_write_ms.count : 0,
+               result->info_us.count ? result->info_us.sum / result->info_us.count : 0,
+               result->seek_ms.count ? result->seek_ms.sum / result->seek_ms.count : 0);
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    fclose(console);
+    free(results);
+
+    return failed;
+}
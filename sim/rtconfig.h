@@ -0,0 +1,35 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * configuration of the host simulation build,the MP3_PLAYER_USING_*
+ * options are passed by the Makefile in MP3_OPTIONS
+ */
+
+#ifndef __RTCONFIG_H__
+#define __RTCONFIG_H__
+
+#define RT_TICK_PER_SECOND 1000
+#define RT_USING_HEAP
+
+/* audio framework */
+#define RT_USING_AUDIO
+#define RT_AUDIO_REPLAY_MP_BLOCK_SIZE 4096
+#define RT_AUDIO_REPLAY_MP_BLOCK_COUNT 2
+
+/* mp3 player */
+#define PKG_USING_MP3PLAYER
+#define MP3_SOUND_DEVICE_NAME "sound0"
+#define MP3_INPUT_BUFFER_SIZE 2048
+#define MP3_OUTPUT_BUFFER_SIZE 4608
+#define MP3_PLAYER_VOLUME_DEFAULT 50
+
+/* files are relative to the working directory */
+#define MP3_PLAYER_CACHE_PATH "mp3_cache.bin"
+#define MP3_LIBRARY_INDEX_PATH "mp3_library.bin"
+
+#endif
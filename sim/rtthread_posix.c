@@ -0,0 +1,808 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * RT-Thread kernel API on POSIX threads
+ *
+ * every rt thread is a pthread scheduled by the host,priorities and stack
+ * sizes are kept but not applied. critical sections and interrupt locks
+ * share one recursive mutex, so they exclude each other like on a single
+ * core target, but only code that takes them.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+struct mem_header
+{
+    rt_size_t size;
+    rt_size_t reserved; /* keeps the block aligned to 16 bytes */
+};
+
+static pthread_mutex_t critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+static rt_size_t heap_used;
+static rt_size_t heap_max_used;
+static struct rt_device *device_list;
+static rt_uint32_t ulog_filter_level = DBG_LOG;
+static struct rt_thread main_thread = {"main"};
+static __thread struct rt_thread *self_thread;
+
+/* initialization functions collected by INIT_APP_EXPORT */
+extern const init_fn_t __start_rti_fn[] __attribute__((weak));
+extern const init_fn_t __stop_rti_fn[] __attribute__((weak));
+
+/**
+ * @description: run functions exported by INIT_APP_EXPORT
+ * @param None
+ * @return None
+ */
+void rt_components_init(void)
+{
+    const init_fn_t *fn;
+
+    for (fn = __start_rti_fn; fn < __stop_rti_fn; fn++)
+        (*fn)();
+}
+
+/**
+ * @description: get absolute monotonic time after a timeout
+ * @param {rt_int32_t} timeout ticks
+ * @param {struct timespec} *ts
+ * @return None
+ */
+static void sim_deadline(rt_int32_t timeout, struct timespec *ts)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout / RT_TICK_PER_SECOND;
+    ts->tv_nsec += (long)(timeout % RT_TICK_PER_SECOND) * (1000000000L / RT_TICK_PER_SECOND);
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @description: init a condition variable on the monotonic clock
+ * @param {pthread_cond_t} *cond
+ * @return None
+ */
+static void sim_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @description: wait on a condition variable until a deadline
+ * @param {pthread_cond_t} *cond
+ * @param {pthread_mutex_t} *lock
+ * @param {rt_int32_t} timeout RT_WAITING_FOREVER to wait without deadline
+ * @param {const struct timespec} *deadline
+ * @return the error code,-RT_ETIMEOUT once the deadline has passed
+ */
+static rt_err_t sim_cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, rt_int32_t timeout, const struct timespec *deadline)
+{
+    if (timeout == RT_WAITING_NO)
+        return -RT_ETIMEOUT;
+    if (timeout < 0)
+        return pthread_cond_wait(cond, lock) == 0 ? RT_EOK : -RT_ERROR;
+    return pthread_cond_timedwait(cond, lock, deadline) == ETIMEDOUT ? -RT_ETIMEOUT : RT_EOK;
+}
+
+static void sim_name_copy(char *dst, const char *name)
+{
+    strncpy(dst, name ? name : "", RT_NAME_MAX - 1);
+    dst[RT_NAME_MAX - 1] = '\0';
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_tick_t)((uint64_t)ts.tv_sec * RT_TICK_PER_SECOND + ts.tv_nsec / (1000000000L / RT_TICK_PER_SECOND));
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    if (ms < 0)
+        return (rt_tick_t)RT_WAITING_FOREVER;
+    return (rt_tick_t)(((uint64_t)ms * RT_TICK_PER_SECOND + 999) / 1000);
+}
+
+void rt_enter_critical(void)
+{
+    pthread_mutex_lock(&critical_lock);
+}
+
+void rt_exit_critical(void)
+{
+    pthread_mutex_unlock(&critical_lock);
+}
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    pthread_mutex_lock(&critical_lock);
+    return 0;
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    RT_UNUSED(level);
+    pthread_mutex_unlock(&critical_lock);
+}
+
+/*
+ * thread
+ */
+static void *sim_thread_entry(void *parameter)
+{
+    struct rt_thread *thread = (struct rt_thread *)parameter;
+
+    self_thread = thread;
+    thread->entry(thread->parameter);
+    return RT_NULL;
+}
+
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    struct rt_thread *thread;
+
+    RT_UNUSED(tick);
+    /* thread objects are not counted as heap,host stacks are not the target's */
+    thread = calloc(1, sizeof(struct rt_thread));
+    if (thread == RT_NULL)
+        return RT_NULL;
+    sim_name_copy(thread->name, name);
+    thread->entry = entry;
+    thread->parameter = parameter;
+    thread->stack_size = stack_size;
+    thread->current_priority = priority;
+    /* kept for stack high-water marks,which read as 0 on the host */
+    thread->stack_addr = malloc(stack_size);
+    if (thread->stack_addr == RT_NULL)
+    {
+        free(thread);
+        return RT_NULL;
+    }
+    memset(thread->stack_addr, '#', stack_size);
+
+    return thread;
+}
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    if (pthread_create(&thread->tid, RT_NULL, sim_thread_entry, thread) != 0)
+        return -RT_ERROR;
+    pthread_detach(thread->tid);
+    return RT_EOK;
+}
+
+rt_thread_t rt_thread_self(void)
+{
+    return self_thread ? self_thread : &main_thread;
+}
+
+rt_err_t rt_thread_yield(void)
+{
+    sched_yield();
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    struct timespec ts;
+
+    ts.tv_sec = tick / RT_TICK_PER_SECOND;
+    ts.tv_nsec = (long)(tick % RT_TICK_PER_SECOND) * (1000000000L / RT_TICK_PER_SECOND);
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    return rt_thread_delay(rt_tick_from_millisecond(ms));
+}
+
+/*
+ * mutex,recursive for the owner like the RT-Thread mutex
+ */
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    pthread_mutexattr_t attr;
+
+    RT_UNUSED(flag);
+    sim_name_copy(mutex->name, name);
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    return RT_EOK;
+}
+
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag)
+{
+    rt_mutex_t mutex = rt_malloc(sizeof(struct rt_mutex));
+
+    if (mutex)
+        rt_mutex_init(mutex, name, flag);
+    return mutex;
+}
+
+rt_err_t rt_mutex_delete(rt_mutex_t mutex)
+{
+    if (mutex == RT_NULL)
+        return -RT_ERROR;
+    pthread_mutex_destroy(&mutex->lock);
+    rt_free(mutex);
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    rt_tick_t start = rt_tick_get();
+
+    if (time < 0)
+        return pthread_mutex_lock(&mutex->lock) == 0 ? RT_EOK : -RT_ERROR;
+
+    /* no monotonic timed lock in POSIX,poll */
+    while (pthread_mutex_trylock(&mutex->lock) != 0)
+    {
+        if (rt_tick_get() - start >= (rt_tick_t)time)
+            return -RT_ETIMEOUT;
+        rt_thread_delay(1);
+    }
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    return pthread_mutex_unlock(&mutex->lock) == 0 ? RT_EOK : -RT_ERROR;
+}
+
+/*
+ * event
+ */
+rt_event_t rt_event_create(const char *name, rt_uint8_t flag)
+{
+    rt_event_t event = rt_malloc(sizeof(struct rt_event));
+
+    RT_UNUSED(flag);
+    if (event == RT_NULL)
+        return RT_NULL;
+    sim_name_copy(event->name, name);
+    pthread_mutex_init(&event->lock, RT_NULL);
+    sim_cond_init(&event->cond);
+    event->set = 0;
+
+    return event;
+}
+
+rt_err_t rt_event_delete(rt_event_t event)
+{
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->lock);
+    rt_free(event);
+    return RT_EOK;
+}
+
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
+{
+    pthread_mutex_lock(&event->lock);
+    event->set |= set;
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->lock);
+    return RT_EOK;
+}
+
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt, rt_int32_t timeout, rt_uint32_t *recved)
+{
+    struct timespec deadline;
+    rt_err_t ret = RT_EOK;
+    rt_uint32_t match;
+
+    sim_deadline(timeout, &deadline);
+    pthread_mutex_lock(&event->lock);
+    while (1)
+    {
+        match = event->set & set;
+        if ((opt & RT_EVENT_FLAG_AND) ? match == set : match != 0)
+            break;
+        ret = sim_cond_wait(&event->cond, &event->lock, timeout, &deadline);
+        if (ret != RT_EOK)
+            break;
+    }
+    if (ret == RT_EOK)
+    {
+        if (recved)
+            *recved = match;
+        if (opt & RT_EVENT_FLAG_CLEAR)
+            event->set &= ~match;
+    }
+    pthread_mutex_unlock(&event->lock);
+
+    return ret;
+}
+
+/*
+ * message queue
+ */
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag)
+{
+    rt_mq_t mq = rt_malloc(sizeof(struct rt_messagequeue));
+
+    RT_UNUSED(flag);
+    if (mq == RT_NULL)
+        return RT_NULL;
+    mq->pool = rt_malloc(msg_size * max_msgs);
+    if (mq->pool == RT_NULL)
+    {
+        rt_free(mq);
+        return RT_NULL;
+    }
+    sim_name_copy(mq->name, name);
+    pthread_mutex_init(&mq->lock, RT_NULL);
+    sim_cond_init(&mq->cond);
+    mq->msg_size = msg_size;
+    mq->max_msgs = max_msgs;
+    mq->entry = 0;
+    mq->head = 0;
+
+    return mq;
+}
+
+rt_err_t rt_mq_delete(rt_mq_t mq)
+{
+    pthread_cond_destroy(&mq->cond);
+    pthread_mutex_destroy(&mq->lock);
+    rt_free(mq->pool);
+    rt_free(mq);
+    return RT_EOK;
+}
+
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    rt_size_t tail;
+
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    pthread_mutex_lock(&mq->lock);
+    if (mq->entry == mq->max_msgs)
+    {
+        pthread_mutex_unlock(&mq->lock);
+        return -RT_EFULL;
+    }
+    tail = (mq->head + mq->entry) % mq->max_msgs;
+    memcpy(mq->pool + tail * mq->msg_size, buffer, size);
+    mq->entry++;
+    pthread_cond_signal(&mq->cond);
+    pthread_mutex_unlock(&mq->lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    struct timespec deadline;
+    rt_err_t ret = RT_EOK;
+
+    sim_deadline(timeout, &deadline);
+    pthread_mutex_lock(&mq->lock);
+    while (mq->entry == 0)
+    {
+        ret = sim_cond_wait(&mq->cond, &mq->lock, timeout, &deadline);
+        if (ret != RT_EOK)
+            break;
+    }
+    if (ret == RT_EOK)
+    {
+        memcpy(buffer, mq->pool + mq->head * mq->msg_size, size < mq->msg_size ? size : mq->msg_size);
+        mq->head = (mq->head + 1) % mq->max_msgs;
+        mq->entry--;
+    }
+    pthread_mutex_unlock(&mq->lock);
+
+    return ret;
+}
+
+/*
+ * completion
+ */
+void rt_completion_init(struct rt_completion *completion)
+{
+    completion->flag = 0;
+    pthread_mutex_init(&completion->lock, RT_NULL);
+    sim_cond_init(&completion->cond);
+}
+
+rt_err_t rt_completion_wait(struct rt_completion *completion, rt_int32_t timeout)
+{
+    struct timespec deadline;
+    rt_err_t ret = RT_EOK;
+
+    sim_deadline(timeout, &deadline);
+    pthread_mutex_lock(&completion->lock);
+    while (!completion->flag)
+    {
+        ret = sim_cond_wait(&completion->cond, &completion->lock, timeout, &deadline);
+        if (ret != RT_EOK)
+            break;
+    }
+    /* back to uncompleted once it is taken */
+    if (ret == RT_EOK)
+        completion->flag = 0;
+    pthread_mutex_unlock(&completion->lock);
+
+    return ret;
+}
+
+void rt_completion_done(struct rt_completion *completion)
+{
+    pthread_mutex_lock(&completion->lock);
+    completion->flag = 1;
+    pthread_cond_broadcast(&completion->cond);
+    pthread_mutex_unlock(&completion->lock);
+}
+
+/*
+ * memory
+ */
+void *rt_malloc(rt_size_t size)
+{
+    struct mem_header *header;
+
+    if (size == 0)
+        return RT_NULL;
+    header = malloc(sizeof(struct mem_header) + size);
+    if (header == RT_NULL)
+        return RT_NULL;
+    header->size = size;
+
+    pthread_mutex_lock(&heap_lock);
+    heap_used += size;
+    if (heap_used > heap_max_used)
+        heap_max_used = heap_used;
+    pthread_mutex_unlock(&heap_lock);
+
+    return header + 1;
+}
+
+void rt_free(void *rmem)
+{
+    struct mem_header *header;
+
+    if (rmem == RT_NULL)
+        return;
+    header = (struct mem_header *)rmem - 1;
+
+    pthread_mutex_lock(&heap_lock);
+    heap_used -= header->size;
+    pthread_mutex_unlock(&heap_lock);
+
+    free(header);
+}
+
+void *rt_realloc(void *rmem, rt_size_t newsize)
+{
+    struct mem_header *header;
+    void *mem;
+
+    if (rmem == RT_NULL)
+        return rt_malloc(newsize);
+    if (newsize == 0)
+    {
+        rt_free(rmem);
+        return RT_NULL;
+    }
+
+    header = (struct mem_header *)rmem - 1;
+    mem = rt_malloc(newsize);
+    if (mem == RT_NULL)
+        return RT_NULL;
+    memcpy(mem, rmem, header->size < newsize ? header->size : newsize);
+    rt_free(rmem);
+
+    return mem;
+}
+
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    void *mem = rt_malloc(count * size);
+
+    if (mem)
+        memset(mem, 0, count * size);
+    return mem;
+}
+
+char *rt_strdup(const char *s)
+{
+    rt_size_t len = strlen(s) + 1;
+    char *dup = rt_malloc(len);
+
+    if (dup)
+        memcpy(dup, s, len);
+    return dup;
+}
+
+/**
+ * @description: get heap usage of rt_malloc,there is no heap limit on the host
+ * @param {rt_size_t} *total always 0
+ * @param {rt_size_t} *used
+ * @param {rt_size_t} *max_used
+ * @return None
+ */
+void rt_memory_info(rt_size_t *total, rt_size_t *used, rt_size_t *max_used)
+{
+    pthread_mutex_lock(&heap_lock);
+    if (total)
+        *total = 0;
+    if (used)
+        *used = heap_used;
+    if (max_used)
+        *max_used = heap_max_used;
+    pthread_mutex_unlock(&heap_lock);
+}
+
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
+{
+    RT_UNUSED(mp);
+    RT_UNUSED(time);
+    return RT_NULL;
+}
+
+void rt_mp_free(void *block)
+{
+    RT_UNUSED(block);
+}
+
+/*
+ * console
+ */
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vprintf(fmt, args);
+    va_end(args);
+    fflush(stdout);
+
+    return len;
+}
+
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+
+    return len;
+}
+
+void ulog_output(rt_uint32_t level, const char *tag, const char *format, ...)
+{
+    static const char level_char[] = "???EW?ID";
+    va_list args;
+
+    if (level > ulog_filter_level)
+        return;
+    fprintf(stderr, "[%c/%s] ", level_char[level & 0x07], tag);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void ulog_global_filter_lvl_set(rt_uint32_t level)
+{
+    ulog_filter_level = level;
+}
+
+/*
+ * device
+ */
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (rt_device_find(name) != RT_NULL)
+        return -RT_ERROR;
+
+    sim_name_copy(dev->name, name);
+    dev->flag = flags;
+    dev->open_flag = RT_DEVICE_OFLAG_CLOSE;
+    dev->ref_count = 0;
+    rt_enter_critical();
+    dev->next = device_list;
+    device_list = dev;
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+    struct rt_device *dev;
+
+    rt_enter_critical();
+    for (dev = device_list; dev; dev = dev->next)
+    {
+        if (strncmp(dev->name, name, RT_NAME_MAX - 1) == 0)
+            break;
+    }
+    rt_exit_critical();
+
+    return dev;
+}
+
+rt_err_t rt_device_open(rt_device_t dev, rt_uint16_t oflag)
+{
+    rt_err_t ret = RT_EOK;
+
+    if (dev->ref_count == 0 && dev->open)
+        ret = dev->open(dev, oflag);
+    if (ret == RT_EOK)
+    {
+        dev->open_flag = oflag | RT_DEVICE_OFLAG_OPEN;
+        dev->ref_count++;
+    }
+    return ret;
+}
+
+rt_err_t rt_device_close(rt_device_t dev)
+{
+    rt_err_t ret = RT_EOK;
+
+    if (dev->ref_count == 0)
+        return -RT_ERROR;
+    if (--dev->ref_count == 0)
+    {
+        if (dev->close)
+            ret = dev->close(dev);
+        dev->open_flag = RT_DEVICE_OFLAG_CLOSE;
+    }
+    return ret;
+}
+
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    if (dev->ref_count == 0 || dev->read == RT_NULL)
+        return 0;
+    return dev->read(dev, pos, buffer, size);
+}
+
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    if (dev->ref_count == 0 || dev->write == RT_NULL)
+        return 0;
+    return dev->write(dev, pos, buffer, size);
+}
+
+rt_err_t rt_device_control(rt_device_t dev, int cmd, void *arg)
+{
+    if (dev->control == RT_NULL)
+        return -RT_ENOSYS;
+    return dev->control(dev, cmd, arg);
+}
+
+/*
+ * data queue
+ */
+rt_err_t rt_data_queue_init(struct rt_data_queue *queue, rt_uint16_t size, rt_uint16_t lwm,
+                            void (*evt_notify)(struct rt_data_queue *queue, rt_uint32_t event))
+{
+    RT_UNUSED(evt_notify);
+    queue->queue = rt_malloc(sizeof(struct rt_data_item) * size);
+    if (queue->queue == RT_NULL)
+        return -RT_ENOMEM;
+    queue->size = size;
+    queue->lwm = lwm;
+    queue->get_index = 0;
+    queue->put_index = 0;
+    queue->count = 0;
+    pthread_mutex_init(&queue->lock, RT_NULL);
+    sim_cond_init(&queue->cond);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_data_queue_push(struct rt_data_queue *queue, const void *data_ptr, rt_size_t data_size, rt_int32_t timeout)
+{
+    struct timespec deadline;
+    rt_err_t ret = RT_EOK;
+
+    sim_deadline(timeout, &deadline);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->size)
+    {
+        ret = sim_cond_wait(&queue->cond, &queue->lock, timeout, &deadline);
+        if (ret != RT_EOK)
+            break;
+    }
+    if (ret == RT_EOK)
+    {
+        queue->queue[queue->put_index].data_ptr = data_ptr;
+        queue->queue[queue->put_index].data_size = data_size;
+        queue->put_index = (queue->put_index + 1) % queue->size;
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
+
+rt_err_t rt_data_queue_pop(struct rt_data_queue *queue, const void **data_ptr, rt_size_t *size, rt_int32_t timeout)
+{
+    struct timespec deadline;
+    rt_err_t ret = RT_EOK;
+
+    sim_deadline(timeout, &deadline);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0)
+    {
+        ret = sim_cond_wait(&queue->cond, &queue->lock, timeout, &deadline);
+        if (ret != RT_EOK)
+            break;
+    }
+    if (ret == RT_EOK)
+    {
+        *data_ptr = queue->queue[queue->get_index].data_ptr;
+        *size = queue->queue[queue->get_index].data_size;
+        queue->get_index = (queue->get_index + 1) % queue->size;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
+
+rt_err_t rt_data_queue_peek(struct rt_data_queue *queue, const void **data_ptr, rt_size_t *size)
+{
+    rt_err_t ret = -RT_EEMPTY;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count != 0)
+    {
+        *data_ptr = queue->queue[queue->get_index].data_ptr;
+        *size = queue->queue[queue->get_index].data_size;
+        ret = RT_EOK;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
+
+rt_uint16_t rt_data_queue_len(struct rt_data_queue *queue)
+{
+    rt_uint16_t len;
+
+    pthread_mutex_lock(&queue->lock);
+    len = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+
+    return len;
+}
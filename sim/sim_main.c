@@ -0,0 +1,174 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * mp3sim,plays mp3 files with mp3player on the host
+ */
+
+#include <rtthread.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "mp3_player.h"
+#include "sim_sound.h"
+
+#define SIM_POLL_MS (10)
+
+/**
+ * @description: decode a file without playing it and print the result
+ * @param {const char} *path
+ * @param {int} quiet
+ * @return the error code,0 on success
+ */
+static rt_err_t sim_bench(const char *path, int quiet)
+{
+    struct mp3_bench bench;
+    rt_err_t ret;
+
+    ret = mp3_player_bench(path, &bench);
+    if (ret != RT_EOK)
+    {
+        fprintf(stderr, "%s: bench failed %d\n", path, (int)ret);
+        return ret;
+    }
+    if (!quiet)
+    {
+        rt_kprintf("%s: %d frames in %d ms, %d errors, %d resyncs, frame %s min %u avg %u max %u\n", path,
+                   (int)bench.frames, (int)(bench.ticks * 1000 / RT_TICK_PER_SECOND), (int)bench.errors,
+                   (int)bench.resyncs, bench.cycles ? "cycles" : "ticks", (unsigned)bench.frame_min,
+                   (unsigned)(bench.frame_total / bench.frames), (unsigned)bench.frame_max);
+    }
+
+    return RT_EOK;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [option] file ...\n"
+            "  -o FILE   write the pcm to FILE as 16 bit stereo,default is a null sink\n"
+            "  -s PCT    device speed in percent of real time,0 as fast as possible(default 100)\n"
+            "  -v VOL    volume(0~99)\n"
+            "  -q        only log warnings and errors,print no summary\n"
+            "  -b        decode the files with mp3_player_bench instead of playing them\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    struct sim_sound_stats before, after;
+    struct mp3_player_stats stats;
+    const char *sink = RT_NULL;
+    uint32_t speed = 100;
+    int volume = -1;
+    int quiet = 0;
+    int bench = 0;
+    int failed = 0;
+    rt_tick_t start, ticks;
+    rt_size_t total, used, max_used;
+    uint64_t samples;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "o:s:v:qbh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o':
+            sink = optarg;
+            break;
+        case 's':
+            speed = strtoul(optarg, RT_NULL, 0);
+            break;
+        case 'v':
+            volume = atoi(optarg);
+            break;
+        case 'q':
+            quiet = 1;
+            break;
+        case 'b':
+            bench = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (quiet)
+        ulog_global_filter_lvl_set(DBG_WARNING);
+
+    /* the device is registered before the player looks it up */
+    if (sim_sound_register(MP3_SOUND_DEVICE_NAME, sink, speed) != RT_EOK)
+        return 1;
+    rt_components_init();
+    /* the player thread sets up its buffers and queue after init,volume is set last */
+    start = rt_tick_get();
+    while (mp3_player_volume_get() != MP3_PLAYER_VOLUME_DEFAULT)
+    {
+        if (rt_tick_get() - start > RT_TICK_PER_SECOND)
+        {
+            fprintf(stderr, "mp3 player did not start\n");
+            return 1;
+        }
+        rt_thread_mdelay(1);
+    }
+    if (volume >= 0)
+        mp3_player_volume_set(volume);
+
+    for (i = optind; i < argc; i++)
+    {
+        if (bench)
+        {
+            if (sim_bench(argv[i], quiet) != RT_EOK)
+                failed = 1;
+            continue;
+        }
+        sim_sound_stats_get(&before);
+        start = rt_tick_get();
+        mp3_player_play(argv[i]);
+        while (mp3_player_state_get() != PLAYER_STATE_STOPED)
+            rt_thread_mdelay(SIM_POLL_MS);
+        sim_sound_drain();
+        ticks = rt_tick_get() - start;
+        sim_sound_stats_get(&after);
+
+        samples = (after.bytes - before.bytes) / 4;
+        if (samples == 0)
+        {
+            fprintf(stderr, "%s: nothing played\n", argv[i]);
+            failed = 1;
+            continue;
+        }
+        if (!quiet)
+        {
+            rt_kprintf("%s: %d.%03d s played in %d ms, %d underruns\n", argv[i],
+                       (int)(samples / after.samplerate), (int)(samples % after.samplerate * 1000 / after.samplerate),
+                       ticks * 1000 / RT_TICK_PER_SECOND, after.underruns - before.underruns);
+        }
+    }
+
+    if (!quiet)
+    {
+        rt_memory_info(&total, &used, &max_used);
+        rt_kprintf("heap: %d bytes used, %d bytes peak\n", (int)used, (int)max_used);
+        if (mp3_player_stats_get(&stats) == RT_EOK)
+        {
+            rt_kprintf("stats: %d frames, %d underruns, %d resyncs, decode avg %d max %d ticks, write max %d ticks, read max %d ticks\n",
+                       (int)stats.frames, (int)stats.underruns, (int)stats.resyncs,
+                       stats.decode.count ? (int)(stats.decode.total / stats.decode.count) : 0, (int)stats.decode.max,
+                       (int)stats.write.max, (int)stats.read.max);
+        }
+    }
+
+    return failed;
+}
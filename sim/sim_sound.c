@@ -0,0 +1,496 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+/*
+ * simulated sound device
+ *
+ * rt_device_write copies pcm into blocks and queues full ones to the
+ * replay data queue like the RT-Thread audio framework. the device thread
+ * plays a dma ring of SIM_SOUND_DMA_BLOCK_COUNT blocks: each played block
+ * is refilled from the queue like _audio_send_replay_frame does on tx
+ * complete,advancing read_index and pos and freeing a replay block once
+ * all of it is copied,silence fills what the queue can not. a dma block
+ * is held for its play time scaled by the speed and its pcm is written
+ * to the sink. the replay fields read by mp3_pcm_output_played are kept
+ * up to date under the interrupt lock.
+ *
+ * unlike the framework,the device stops when the queue and the dma ring
+ * are both empty,so a drain can wait for the last sample.
+ */
+
+#include "sim_sound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LOG_TAG "sim sound"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#define SIM_SOUND_BLOCK_SIZE RT_AUDIO_REPLAY_MP_BLOCK_SIZE
+#define SIM_SOUND_BLOCK_COUNT RT_AUDIO_REPLAY_MP_BLOCK_COUNT
+
+/* dma ring of the codec,smaller blocks than the replay ones like on most boards */
+#define SIM_SOUND_DMA_BLOCK_SIZE (1024)
+#define SIM_SOUND_DMA_BLOCK_COUNT (2)
+
+#define SIM_SOUND_THREAD_STACK_SIZE (1024)
+#define SIM_SOUND_THREAD_PRIORITY (5) /* dma,above every player thread */
+
+struct sim_sound
+{
+    struct rt_audio_device audio;
+    struct rt_audio_replay replay;
+
+    rt_uint8_t *pool;                         /* SIM_SOUND_BLOCK_COUNT blocks */
+    rt_uint8_t *free_blocks[SIM_SOUND_BLOCK_COUNT];
+    rt_uint32_t free_count;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; /* a block was freed or queued,or the device stopped */
+
+    rt_uint8_t *dma;                             /* SIM_SOUND_DMA_BLOCK_COUNT blocks */
+    rt_uint32_t valid[SIM_SOUND_DMA_BLOCK_COUNT]; /* pcm bytes of each dma block,the rest is silence */
+
+    FILE *sink;
+    uint32_t speed;
+    struct timespec deadline; /* end of play time of the block in dma */
+    rt_uint8_t playing;       /* deadline is valid */
+    rt_uint8_t idle;          /* drained,the next wait for a block is not an underrun */
+    rt_uint8_t draining;      /* the queue runs empty on purpose */
+    rt_uint8_t starved;       /* the last dma block was short of pcm */
+    struct sim_sound_stats stats;
+    rt_thread_t tid;
+};
+
+static struct sim_sound sound;
+
+static uint64_t sim_sound_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @description: take a free block,wait until the device gives one back
+ * @param {struct sim_sound} *snd
+ * @return block
+ */
+static rt_uint8_t *sim_sound_block_alloc(struct sim_sound *snd)
+{
+    rt_uint8_t *block;
+
+    pthread_mutex_lock(&snd->lock);
+    while (snd->free_count == 0)
+        pthread_cond_wait(&snd->cond, &snd->lock);
+    block = snd->free_blocks[--snd->free_count];
+    pthread_mutex_unlock(&snd->lock);
+
+    return block;
+}
+
+/**
+ * @description: give a played block back
+ * @param {struct sim_sound} *snd
+ * @param {rt_uint8_t} *block
+ * @return None
+ */
+static void sim_sound_block_free(struct sim_sound *snd, rt_uint8_t *block)
+{
+    pthread_mutex_lock(&snd->lock);
+    snd->free_blocks[snd->free_count++] = block;
+    pthread_cond_broadcast(&snd->cond);
+    pthread_mutex_unlock(&snd->lock);
+}
+
+/**
+ * @description: wake up the device thread and drain waiters
+ * @param {struct sim_sound} *snd
+ * @return None
+ */
+static void sim_sound_wakeup(struct sim_sound *snd)
+{
+    pthread_mutex_lock(&snd->lock);
+    pthread_cond_broadcast(&snd->cond);
+    pthread_mutex_unlock(&snd->lock);
+}
+
+/**
+ * @description: hold a block for its play time
+ * @param {struct sim_sound} *snd
+ * @param {rt_size_t} size bytes of the block
+ * @return None
+ */
+static void sim_sound_pace(struct sim_sound *snd, rt_size_t size)
+{
+    uint64_t ns;
+
+    if (snd->speed == 0 || snd->stats.samplerate == 0)
+        return;
+
+    /* 16 bit stereo */
+    ns = (uint64_t)size * 1000000000ull * 100 / ((uint64_t)snd->stats.samplerate * 4 * snd->speed);
+    if (!snd->playing)
+    {
+        /* restart the clock after an underrun */
+        clock_gettime(CLOCK_MONOTONIC, &snd->deadline);
+        snd->playing = 1;
+    }
+    snd->deadline.tv_sec += ns / 1000000000ull;
+    snd->deadline.tv_nsec += ns % 1000000000ull;
+    if (snd->deadline.tv_nsec >= 1000000000L)
+    {
+        snd->deadline.tv_sec++;
+        snd->deadline.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &snd->deadline, RT_NULL) != 0)
+        ;
+}
+
+/**
+ * @description: fill the dma block at replay->pos from the replay queue,
+ *               like the audio framework does on tx complete
+ * @param {struct sim_sound} *snd
+ * @return pcm bytes copied,the rest of the block is silence
+ */
+static rt_uint32_t sim_sound_fill(struct sim_sound *snd)
+{
+    struct rt_audio_replay *replay = &snd->replay;
+    rt_uint8_t *dst = replay->buf_info.buffer + replay->pos;
+    const void *block;
+    rt_size_t size, len;
+    rt_uint32_t valid = 0;
+    rt_base_t level;
+
+    while (valid < SIM_SOUND_DMA_BLOCK_SIZE &&
+           rt_data_queue_peek(&replay->queue, &block, &size) == RT_EOK)
+    {
+        len = size - replay->read_index;
+        if (len > SIM_SOUND_DMA_BLOCK_SIZE - valid)
+            len = SIM_SOUND_DMA_BLOCK_SIZE - valid;
+        memcpy(dst + valid, (const rt_uint8_t *)block + replay->read_index, len);
+        valid += len;
+
+        level = rt_hw_interrupt_disable();
+        replay->read_index += len;
+        rt_hw_interrupt_enable(level);
+        if (replay->read_index == size)
+        {
+            /* all of the block is in dma,give it back */
+            rt_data_queue_pop(&replay->queue, &block, &size, RT_WAITING_NO);
+            level = rt_hw_interrupt_disable();
+            replay->read_index = 0;
+            rt_hw_interrupt_enable(level);
+            sim_sound_block_free(snd, (rt_uint8_t *)block);
+        }
+    }
+    memset(dst + valid, 0, SIM_SOUND_DMA_BLOCK_SIZE - valid);
+
+    level = rt_hw_interrupt_disable();
+    replay->pos = (replay->pos + SIM_SOUND_DMA_BLOCK_SIZE) % replay->buf_info.total_size;
+    rt_hw_interrupt_enable(level);
+
+    /* running out of pcm while playing,not at stream end */
+    if (valid < SIM_SOUND_DMA_BLOCK_SIZE && !snd->starved && snd->playing && !snd->draining && !snd->idle)
+        snd->stats.underruns++;
+    snd->starved = valid < SIM_SOUND_DMA_BLOCK_SIZE;
+
+    return valid;
+}
+
+/**
+ * @description: device thread,plays the dma ring
+ * @param {void *}parameter
+ * @return None
+ */
+static void sim_sound_entry(void *parameter)
+{
+    struct sim_sound *snd = (struct sim_sound *)parameter;
+    struct rt_audio_replay *replay = &snd->replay;
+    rt_uint32_t i, slot, pending;
+    rt_base_t level;
+
+    while (1)
+    {
+        if (replay->activated != RT_TRUE)
+        {
+            pthread_mutex_lock(&snd->lock);
+            while (rt_data_queue_len(&replay->queue) == 0)
+                pthread_cond_wait(&snd->cond, &snd->lock);
+            pthread_mutex_unlock(&snd->lock);
+
+            /* start of replay fills the whole ring */
+            level = rt_hw_interrupt_disable();
+            replay->activated = RT_TRUE;
+            replay->pos = 0;
+            rt_hw_interrupt_enable(level);
+            snd->playing = 0; /* the clock restarts with this block */
+            snd->starved = 0;
+            for (i = 0; i < SIM_SOUND_DMA_BLOCK_COUNT; i++)
+                snd->valid[i] = sim_sound_fill(snd);
+            snd->idle = 0;
+        }
+
+        /* the block at pos is the oldest one,it plays next and is refilled when done */
+        slot = replay->pos / SIM_SOUND_DMA_BLOCK_SIZE;
+        sim_sound_pace(snd, SIM_SOUND_DMA_BLOCK_SIZE);
+        if (snd->sink && snd->valid[slot])
+            fwrite(replay->buf_info.buffer + replay->pos, 1, snd->valid[slot], snd->sink);
+        if (snd->valid[slot])
+        {
+            snd->stats.bytes += snd->valid[slot];
+            snd->stats.blocks++;
+        }
+        snd->valid[slot] = sim_sound_fill(snd);
+
+        pending = 0;
+        for (i = 0; i < SIM_SOUND_DMA_BLOCK_COUNT; i++)
+            pending += snd->valid[i];
+        if (pending == 0)
+        {
+            /* only silence left,stop until pcm is queued again */
+            level = rt_hw_interrupt_disable();
+            replay->activated = RT_FALSE;
+            rt_hw_interrupt_enable(level);
+            sim_sound_wakeup(snd);
+        }
+    }
+}
+
+/**
+ * @description: queue the block being filled
+ * @param {struct sim_sound} *snd
+ * @return None
+ */
+static void sim_sound_push(struct sim_sound *snd)
+{
+    struct rt_audio_replay *replay = &snd->replay;
+    rt_uint8_t *block;
+    rt_size_t size;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    block = replay->write_data;
+    size = replay->write_index;
+    replay->write_data = RT_NULL;
+    replay->write_index = 0;
+    rt_hw_interrupt_enable(level);
+
+    if (block == RT_NULL)
+        return;
+    if (size == 0)
+    {
+        sim_sound_block_free(snd, block);
+        return;
+    }
+    rt_data_queue_push(&replay->queue, block, size, RT_WAITING_FOREVER);
+    sim_sound_wakeup(snd);
+}
+
+static rt_err_t sim_sound_open(rt_device_t dev, rt_uint16_t oflag)
+{
+    RT_UNUSED(dev);
+    RT_UNUSED(oflag);
+    return RT_EOK;
+}
+
+static rt_err_t sim_sound_close(rt_device_t dev)
+{
+    RT_UNUSED(dev);
+    sim_sound_drain();
+    return RT_EOK;
+}
+
+static rt_size_t sim_sound_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct sim_sound *snd = (struct sim_sound *)dev;
+    struct rt_audio_replay *replay = &snd->replay;
+    const rt_uint8_t *data = buffer;
+    rt_size_t left = size, len;
+    rt_uint8_t *block;
+    rt_base_t level;
+
+    RT_UNUSED(pos);
+    if (size > 0 && snd->stats.first_write_ns == 0)
+        snd->stats.first_write_ns = sim_sound_now();
+    while (left > 0)
+    {
+        if (replay->write_data == RT_NULL)
+        {
+            /* blocks while all blocks are queued or in dma */
+            block = sim_sound_block_alloc(snd);
+            level = rt_hw_interrupt_disable();
+            replay->write_data = block;
+            replay->write_index = 0;
+            rt_hw_interrupt_enable(level);
+        }
+
+        len = SIM_SOUND_BLOCK_SIZE - replay->write_index;
+        if (len > left)
+            len = left;
+        memcpy(replay->write_data + replay->write_index, data, len);
+        level = rt_hw_interrupt_disable();
+        replay->write_index += len;
+        rt_hw_interrupt_enable(level);
+        data += len;
+        left -= len;
+
+        if (replay->write_index == SIM_SOUND_BLOCK_SIZE)
+            sim_sound_push(snd);
+    }
+
+    return size;
+}
+
+static rt_err_t sim_sound_control(rt_device_t dev, int cmd, void *args)
+{
+    struct sim_sound *snd = (struct sim_sound *)dev;
+    struct rt_audio_caps *caps = (struct rt_audio_caps *)args;
+
+    if (cmd != AUDIO_CTL_CONFIGURE || caps == RT_NULL)
+        return -RT_ENOSYS;
+
+    switch (caps->main_type)
+    {
+    case AUDIO_TYPE_OUTPUT:
+        if (caps->udata.config.channels != 2 || caps->udata.config.samplebits != 16)
+        {
+            LOG_E("only 16 bit stereo is simulated");
+            return -RT_EINVAL;
+        }
+        if (snd->stats.samplerate != caps->udata.config.samplerate)
+            LOG_I("samplerate %d Hz", caps->udata.config.samplerate);
+        snd->stats.samplerate = caps->udata.config.samplerate;
+        break;
+
+    case AUDIO_TYPE_MIXER:
+        if (caps->sub_type == AUDIO_MIXER_VOLUME)
+            snd->stats.volume = caps->udata.value;
+        break;
+
+    default:
+        return -RT_ENOSYS;
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @description: register a simulated sound device of the audio framework,
+ *               pcm is queued in RT_AUDIO_REPLAY_MP_BLOCK_COUNT blocks of
+ *               RT_AUDIO_REPLAY_MP_BLOCK_SIZE bytes and played from a dma
+ *               ring of smaller blocks
+ * @param {const char} *name device name
+ * @param {const char} *sink file the pcm is written to as 16 bit stereo,RT_NULL for a null sink
+ * @param {uint32_t} speed playback rate in percent of real time,0 plays as fast as possible
+ * @return the error code,0 on success
+ */
+rt_err_t sim_sound_register(const char *name, const char *sink, uint32_t speed)
+{
+    struct sim_sound *snd = &sound;
+    int i;
+
+    memset(snd, 0, sizeof(struct sim_sound));
+    snd->speed = speed;
+    if (sink)
+    {
+        snd->sink = fopen(sink, "wb");
+        if (snd->sink == RT_NULL)
+        {
+            LOG_E("can not open %s", sink);
+            return -RT_ERROR;
+        }
+    }
+
+    /* the pool is not rt_malloc'ed,it is the device's memory */
+    snd->pool = malloc(SIM_SOUND_BLOCK_SIZE * SIM_SOUND_BLOCK_COUNT);
+    if (snd->pool == RT_NULL)
+        return -RT_ENOMEM;
+    for (i = 0; i < SIM_SOUND_BLOCK_COUNT; i++)
+        snd->free_blocks[i] = snd->pool + i * SIM_SOUND_BLOCK_SIZE;
+    snd->free_count = SIM_SOUND_BLOCK_COUNT;
+    snd->dma = malloc(SIM_SOUND_DMA_BLOCK_SIZE * SIM_SOUND_DMA_BLOCK_COUNT);
+    if (snd->dma == RT_NULL)
+        return -RT_ENOMEM;
+    snd->replay.buf_info.buffer = snd->dma;
+    snd->replay.buf_info.block_size = SIM_SOUND_DMA_BLOCK_SIZE;
+    snd->replay.buf_info.block_count = SIM_SOUND_DMA_BLOCK_COUNT;
+    snd->replay.buf_info.total_size = SIM_SOUND_DMA_BLOCK_SIZE * SIM_SOUND_DMA_BLOCK_COUNT;
+    pthread_mutex_init(&snd->lock, RT_NULL);
+    pthread_cond_init(&snd->cond, RT_NULL);
+
+    if (rt_data_queue_init(&snd->replay.queue, SIM_SOUND_BLOCK_COUNT, 0, RT_NULL) != RT_EOK)
+        return -RT_ENOMEM;
+    snd->audio.replay = &snd->replay;
+
+    snd->audio.parent.type = RT_Device_Class_Sound;
+    snd->audio.parent.open = sim_sound_open;
+    snd->audio.parent.close = sim_sound_close;
+    snd->audio.parent.write = sim_sound_write;
+    snd->audio.parent.control = sim_sound_control;
+
+    snd->tid = rt_thread_create("sim_snd", sim_sound_entry, snd,
+                                SIM_SOUND_THREAD_STACK_SIZE, SIM_SOUND_THREAD_PRIORITY, 10);
+    if (snd->tid == RT_NULL)
+        return -RT_ERROR;
+    rt_thread_startup(snd->tid);
+
+    return rt_device_register(&snd->audio.parent, name, RT_DEVICE_FLAG_WRONLY);
+}
+
+/**
+ * @description: wait until all pcm written to the device has been played,
+ *               a partly filled block is played too
+ * @param None
+ * @return None
+ */
+void sim_sound_drain(void)
+{
+    struct sim_sound *snd = &sound;
+
+    snd->draining = 1;
+    sim_sound_push(snd);
+    pthread_mutex_lock(&snd->lock);
+    while (snd->free_count != SIM_SOUND_BLOCK_COUNT || snd->replay.activated == RT_TRUE)
+        pthread_cond_wait(&snd->cond, &snd->lock);
+    pthread_mutex_unlock(&snd->lock);
+    snd->draining = 0;
+    snd->idle = 1;
+    if (snd->sink)
+        fflush(snd->sink);
+}
+
+/**
+ * @description: change the playback rate,call it while the device is drained
+ * @param {uint32_t} speed playback rate in percent of real time,0 plays as fast as possible
+ * @return None
+ */
+void sim_sound_speed_set(uint32_t speed)
+{
+    sound.speed = speed;
+}
+
+/**
+ * @description: clear first_write_ns,the next pcm write is timed
+ * @param None
+ * @return None
+ */
+void sim_sound_mark(void)
+{
+    sound.stats.first_write_ns = 0;
+}
+
+/**
+ * @description: get statistics of the simulated sound device
+ * @param {struct sim_sound_stats} *stats
+ * @return None
+ */
+void sim_sound_stats_get(struct sim_sound_stats *stats)
+{
+    *stats = sound.stats;
+}
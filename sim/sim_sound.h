@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#ifndef __SIM_SOUND_H__
+#define __SIM_SOUND_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+/*
+ * simulated sound device statistics
+ */
+struct sim_sound_stats
+{
+    uint64_t bytes;          /* pcm bytes played */
+    uint32_t blocks;         /* dma blocks played with pcm in them */
+    uint32_t underruns;      /* times the device ran out of pcm while playing */
+    uint32_t samplerate;     /* current samplerate */
+    int volume;              /* current volume,not applied to the pcm */
+    uint64_t first_write_ns; /* monotonic time of the first pcm write after sim_sound_mark,0 if none */
+};
+
+/**
+ * @description: register a simulated sound device of the audio framework,
+ *               pcm is queued in RT_AUDIO_REPLAY_MP_BLOCK_COUNT blocks of
+ *               RT_AUDIO_REPLAY_MP_BLOCK_SIZE bytes and played from a dma
+ *               ring of smaller blocks
+ * @param {const char} *name device name
+ * @param {const char} *sink file the pcm is written to as 16 bit stereo,RT_NULL for a null sink
+ * @param {uint32_t} speed playback rate in percent of real time,0 plays as fast as possible
+ * @return the error code,0 on success
+ */
+rt_err_t sim_sound_register(const char *name, const char *sink, uint32_t speed);
+
+/**
+ * @description: wait until all pcm written to the device has been played,
+ *               a partly filled block is played too
+ * @param None
+ * @return None
+ */
+void sim_sound_drain(void);
+
+/**
+ * @description: change the playback rate,call it while the device is drained
+ * @param {uint32_t} speed playback rate in percent of real time,0 plays as fast as possible
+ * @return None
+ */
+void sim_sound_speed_set(uint32_t speed);
+
+/**
+ * @description: clear first_write_ns,the next pcm write is timed
+ * @param None
+ * @return None
+ */
+void sim_sound_mark(void);
+
+/**
+ * @description: get statistics of the simulated sound device
+ * @param {struct sim_sound_stats} *stats
+ * @return None
+ */
+void sim_sound_stats_get(struct sim_sound_stats *stats);
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_cache.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define LOG_TAG "mp3 cache"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#define MP3_CACHE_VERSION (1)
+#define MP3_CACHE_RECORD_MAGIC (0x5233504D) /* "MP3R" */
+
+#define MP3_CACHE_RECORD_SIZE (sizeof(struct mp3_cache_key) + sizeof(mp3_info_t))
+
+/* zeros written per call while the file is preallocated */
+#define MP3_CACHE_FILL_SIZE (512)
+
+/**
+ * @description: FNV-1a hash
+ * @param {const char} *str
+ * @return {uint32_t} hash
+ */
+static uint32_t mp3_cache_fnv1a(const char *str)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*str)
+    {
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @description: djb2 hash
+ * @param {const char} *str
+ * @return {uint32_t} hash
+ */
+static uint32_t mp3_cache_djb2(const char *str)
+{
+    uint32_t hash = 5381;
+
+    while (*str)
+        hash = hash * 33 ^ (uint8_t)*str++;
+
+    return hash;
+}
+
+/**
+ * @description: get file offset of a record slot
+ * @param {uint32_t} slot
+ * @return file offset
+ */
+static long mp3_cache_slot_offset(uint32_t slot)
+{
+    return sizeof(struct mp3_cache_header) + (long)slot * MP3_CACHE_RECORD_SIZE;
+}
+
+/**
+ * @description: read key of a record slot
+ * @param {struct mp3_cache} *cache
+ * @param {uint32_t} slot
+ * @param {struct mp3_cache_key} *key
+ * @return the error code,RT_ERROR if the slot is not used
+ */
+static rt_err_t mp3_cache_key_read(struct mp3_cache *cache, uint32_t slot, struct mp3_cache_key *key)
+{
+    /* slots past the end of file are unused,e.g. of a file whose preallocation was cut off */
+    if (lseek(cache->fd, mp3_cache_slot_offset(slot), SEEK_SET) < 0 ||
+        read(cache->fd, key, sizeof(struct mp3_cache_key)) != sizeof(struct mp3_cache_key))
+        return RT_ERROR;
+
+    return key->magic == MP3_CACHE_RECORD_MAGIC ? RT_EOK : RT_ERROR;
+}
+
+/**
+ * @description: write empty slots up to the end of the cache file,so a put never
+ *               makes the file system zero-fill megabytes while a track starts
+ * @param {struct mp3_cache} *cache
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_cache_fill(struct mp3_cache *cache)
+{
+    uint8_t *zero;
+    long left, len;
+    rt_err_t ret = RT_EOK;
+
+    zero = rt_malloc(MP3_CACHE_FILL_SIZE);
+    if (zero == RT_NULL)
+        return -RT_ENOMEM;
+    memset(zero, 0, MP3_CACHE_FILL_SIZE);
+
+    left = mp3_cache_slot_offset(cache->slots) - mp3_cache_slot_offset(0);
+    if (lseek(cache->fd, mp3_cache_slot_offset(0), SEEK_SET) < 0)
+        ret = RT_ERROR;
+    while (ret == RT_EOK && left > 0)
+    {
+        len = left < MP3_CACHE_FILL_SIZE ? left : MP3_CACHE_FILL_SIZE;
+        if (write(cache->fd, zero, len) != len)
+            ret = RT_ERROR;
+        left -= len;
+    }
+    rt_free(zero);
+
+    return ret;
+}
+
+/**
+ * @description: open cache file,it is created or rebuilt if it does not match,
+ *               a new file is preallocated with all its slots
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {uint32_t} slots record slots,power of two
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_cache_open(struct mp3_cache *cache, const char *path, uint32_t slots)
+{
+    struct mp3_cache_header header;
+
+    if (slots == 0 || (slots & (slots - 1)) != 0)
+        return -RT_EINVAL;
+
+    memset(cache, 0, sizeof(struct mp3_cache));
+    cache->slots = slots;
+    cache->fd = -1;
+    cache->lock = rt_mutex_create("mp3_cache", RT_IPC_FLAG_FIFO);
+    if (cache->lock == RT_NULL)
+        return -RT_ENOMEM;
+
+    cache->fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (cache->fd < 0)
+        goto __exit;
+
+    if (read(cache->fd, &header, sizeof(header)) == sizeof(header) &&
+        memcmp(header.magic, "MP3C", 4) == 0 &&
+        header.version == MP3_CACHE_VERSION &&
+        header.record_size == MP3_CACHE_RECORD_SIZE &&
+        header.slots == slots)
+        return RT_EOK;
+
+    /* new file or made by another build,start over */
+    LOG_I("create %s", path);
+    close(cache->fd);
+    cache->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (cache->fd < 0)
+        goto __exit;
+
+    memcpy(header.magic, "MP3C", 4);
+    header.version = MP3_CACHE_VERSION;
+    header.record_size = MP3_CACHE_RECORD_SIZE;
+    header.slots = slots;
+    if (write(cache->fd, &header, sizeof(header)) == sizeof(header) && mp3_cache_fill(cache) == RT_EOK)
+        return RT_EOK;
+    close(cache->fd);
+
+__exit:
+    LOG_E("can not open %s", path);
+    rt_mutex_delete(cache->lock);
+    cache->lock = RT_NULL;
+    cache->fd = -1;
+    return RT_ERROR;
+}
+
+/**
+ * @description: close cache file
+ * @param {struct mp3_cache} *cache
+ * @return None
+ */
+void mp3_cache_close(struct mp3_cache *cache)
+{
+    if (cache->fd < 0)
+        return;
+
+    close(cache->fd);
+    cache->fd = -1;
+    rt_mutex_delete(cache->lock);
+    cache->lock = RT_NULL;
+}
+
+/**
+ * @description: look up mp3 info of a file,the file is not opened
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {mp3_info_t} *info
+ * @return the error code,0 on success,RT_ERROR if not cached or file size/mtime changed
+ */
+rt_err_t mp3_cache_get(struct mp3_cache *cache, const char *path, mp3_info_t *info)
+{
+    struct mp3_cache_key key;
+    struct stat st;
+    uint32_t hash, hash2, slot, i;
+    rt_err_t ret = RT_ERROR;
+
+    if (cache->fd < 0 || stat(path, &st) != 0)
+        return RT_ERROR;
+
+    hash = mp3_cache_fnv1a(path);
+    hash2 = mp3_cache_djb2(path);
+    slot = hash & (cache->slots - 1);
+
+    rt_mutex_take(cache->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < MP3_CACHE_MAX_PROBES; i++)
+    {
+        if (mp3_cache_key_read(cache, slot, &key) != RT_EOK)
+            break; /* end of probe chain */
+        if (key.hash == hash && key.hash2 == hash2)
+        {
+            /* record follows its key,no seek needed */
+            if (key.size == (uint32_t)st.st_size && key.mtime == (uint32_t)st.st_mtime &&
+                read(cache->fd, info, sizeof(mp3_info_t)) == sizeof(mp3_info_t))
+                ret = RT_EOK;
+            break;
+        }
+        slot = (slot + (hash2 | 1)) & (cache->slots - 1);
+    }
+    if (ret == RT_EOK)
+        cache->hits++;
+    else
+        cache->misses++;
+    rt_mutex_release(cache->lock);
+
+    return ret;
+}
+
+/**
+ * @description: add or update mp3 info of a file
+ * @param {struct mp3_cache} *cache
+ * @param {const char} *path
+ * @param {const mp3_info_t} *info
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_cache_put(struct mp3_cache *cache, const char *path, const mp3_info_t *info)
+{
+    struct mp3_cache_key key;
+    struct stat st;
+    uint32_t hash, hash2, slot, first, i;
+    long offset;
+    rt_err_t ret = RT_ERROR;
+
+    if (cache->fd < 0 || stat(path, &st) != 0)
+        return RT_ERROR;
+
+    hash = mp3_cache_fnv1a(path);
+    hash2 = mp3_cache_djb2(path);
+    slot = first = hash & (cache->slots - 1);
+
+    rt_mutex_take(cache->lock, RT_WAITING_FOREVER);
+    /* find the record of this path or a free slot,replace the first slot if the chain is full */
+    for (i = 0; i < MP3_CACHE_MAX_PROBES; i++)
+    {
+        if (mp3_cache_key_read(cache, slot, &key) != RT_EOK ||
+            (key.hash == hash && key.hash2 == hash2))
+            break;
+        slot = (slot + (hash2 | 1)) & (cache->slots - 1);
+    }
+    if (i == MP3_CACHE_MAX_PROBES)
+        slot = first;
+
+    /* the key is invalid until the whole record is written */
+    offset = mp3_cache_slot_offset(slot);
+    memset(&key, 0, sizeof(key));
+    if (lseek(cache->fd, offset, SEEK_SET) < 0 ||
+        write(cache->fd, &key, sizeof(key)) != sizeof(key) ||
+        write(cache->fd, info, sizeof(mp3_info_t)) != sizeof(mp3_info_t))
+        goto __exit;
+
+    key.magic = MP3_CACHE_RECORD_MAGIC;
+    key.hash = hash;
+    key.hash2 = hash2;
+    key.size = st.st_size;
+    key.mtime = st.st_mtime;
+    if (lseek(cache->fd, offset, SEEK_SET) < 0 ||
+        write(cache->fd, &key, sizeof(key)) != sizeof(key))
+        goto __exit;
+    ret = RT_EOK;
+
+__exit:
+    rt_mutex_release(cache->lock);
+    if (ret != RT_EOK)
+        LOG_W("can not cache %s", path);
+    return ret;
+}
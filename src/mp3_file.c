@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_file.h"
+
+#ifdef MP3_PLAYER_USING_RAW_FILE
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef MP3_PLAYER_USING_RAW_FILE
+
+/**
+ * @description: open file for reading
+ * @param {const char} *path
+ * @return file,MP3_FILE_NULL on error
+ */
+mp3_file_t mp3_file_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+
+    return fd < 0 ? MP3_FILE_NULL : fd;
+}
+
+/**
+ * @description: close file
+ * @param {mp3_file_t} file
+ * @return None
+ */
+void mp3_file_close(mp3_file_t file)
+{
+    close(file);
+}
+
+/**
+ * @description: read from current position
+ * @param {mp3_file_t} file
+ * @param {void} *buf
+ * @param {uint32_t} len
+ * @return bytes read,0 on end of file or error
+ */
+uint32_t mp3_file_read(mp3_file_t file, void *buf, uint32_t len)
+{
+    uint32_t total = 0;
+    int size;
+
+    /* dfs may return less than asked for before the end of file */
+    while (total < len)
+    {
+        size = read(file, (uint8_t *)buf + total, len - total);
+        if (size <= 0)
+            break;
+        total += size;
+    }
+
+    return total;
+}
+
+/**
+ * @description: move current position
+ * @param {mp3_file_t} file
+ * @param {long} offset
+ * @param {int} whence SEEK_SET,SEEK_CUR or SEEK_END
+ * @return 0 on success,-1 on error
+ */
+int mp3_file_seek(mp3_file_t file, long offset, int whence)
+{
+    return lseek(file, offset, whence) < 0 ? -1 : 0;
+}
+
+/**
+ * @description: get current position
+ * @param {mp3_file_t} file
+ * @return current position,-1 on error
+ */
+long mp3_file_tell(mp3_file_t file)
+{
+    return lseek(file, 0, SEEK_CUR);
+}
+
+/**
+ * @description: get file size
+ * @param {mp3_file_t} file
+ * @return file size,-1 on error
+ */
+long mp3_file_size(mp3_file_t file)
+{
+    struct stat st;
+
+    if (fstat(file, &st) != 0)
+        return -1;
+    return st.st_size;
+}
+
+#else
+
+mp3_file_t mp3_file_open(const char *path)
+{
+    return fopen(path, "rb"); /* readonly */
+}
+
+void mp3_file_close(mp3_file_t file)
+{
+    fclose(file);
+}
+
+uint32_t mp3_file_read(mp3_file_t file, void *buf, uint32_t len)
+{
+    return fread(buf, 1, len, file);
+}
+
+int mp3_file_seek(mp3_file_t file, long offset, int whence)
+{
+    return fseek(file, offset, whence) != 0 ? -1 : 0;
+}
+
+long mp3_file_tell(mp3_file_t file)
+{
+    return ftell(file);
+}
+
+long mp3_file_size(mp3_file_t file)
+{
+    long pos = ftell(file);
+    long size;
+
+    if (fseek(file, 0, SEEK_END) != 0)
+        return -1;
+    size = ftell(file);
+    fseek(file, pos, SEEK_SET);
+    return size;
+}
+
+#endif
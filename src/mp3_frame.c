@@ -0,0 +1,309 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_frame.h"
+#include "mp3dec.h"
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* kbit/s, [MPEG1, MPEG2/2.5][layer - 1][index] */
+static const uint16_t bitrate_tab[2][3][15] = {
+    {
+        {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+        {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+    },
+    {
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+    },
+};
+
+/* Hz, [MPEG1, MPEG2, MPEG25][index] */
+static const uint16_t samplerate_tab[3][3] = {
+    {44100, 48000, 32000},
+    {22050, 24000, 16000},
+    {11025, 12000, 8000},
+};
+
+/**
+ * @description: parse a 4 bytes mpeg audio frame header
+ * @param {uint8_t} *buf
+ * @param {mp3_frame_header_t} *header
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_frame_header_parse(const uint8_t *buf, mp3_frame_header_t *header)
+{
+    uint8_t version_bits, layer_bits, bitrate_index, samplerate_index;
+
+    if (buf[0] != 0xFF || (buf[1] & 0xE0) != 0xE0)
+        return RT_ERROR;
+
+    version_bits = (buf[1] >> 3) & 0x03;
+    layer_bits = (buf[1] >> 1) & 0x03;
+    bitrate_index = buf[2] >> 4;
+    samplerate_index = (buf[2] >> 2) & 0x03;
+
+    /* reserved values, free format is not supported */
+    if (version_bits == 1 || layer_bits == 0 || bitrate_index == 0 || bitrate_index == 15 || samplerate_index == 3)
+        return RT_ERROR;
+
+    if (version_bits == 3)
+        header->version = MPEG1;
+    else if (version_bits == 2)
+        header->version = MPEG2;
+    else
+        header->version = MPEG25;
+    header->layer = 4 - layer_bits;
+    header->padding = (buf[2] >> 1) & 0x01;
+    header->channels = ((buf[3] >> 6) == 3) ? 1 : 2;
+    header->bitrate = bitrate_tab[header->version == MPEG1 ? 0 : 1][header->layer - 1][bitrate_index] * 1000;
+    header->samplerate = samplerate_tab[header->version][samplerate_index];
+
+    switch (header->layer)
+    {
+    case 1:
+        header->samples = 384;
+        header->frame_size = (12 * header->bitrate / header->samplerate + header->padding) * 4;
+        break;
+    case 2:
+        header->samples = 1152;
+        header->frame_size = 144 * header->bitrate / header->samplerate + header->padding;
+        break;
+    default:
+        if (header->version == MPEG1)
+        {
+            header->samples = 1152;
+            header->frame_size = 144 * header->bitrate / header->samplerate + header->padding;
+        }
+        else
+        {
+            header->samples = 576;
+            header->frame_size = 72 * header->bitrate / header->samplerate + header->padding;
+        }
+        break;
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @description: check if two frame headers belong to the same stream
+ * @param {const mp3_frame_header_t} *a
+ * @param {const mp3_frame_header_t} *b
+ * @return RT_TRUE if version,layer and samplerate agree
+ */
+rt_bool_t mp3_frame_header_match(const mp3_frame_header_t *a, const mp3_frame_header_t *b)
+{
+    return a->version == b->version && a->layer == b->layer && a->samplerate == b->samplerate;
+}
+
+/**
+ * @description: find a frame sync confirmed by the frame headers following it,
+ *               a bad region is skipped in one call
+ * @param {const uint8_t} *buf
+ * @param {uint32_t} len
+ * @param {uint8_t} eof no data follows buf
+ * @param {const mp3_frame_header_t} *ref header of the stream,a candidate that can not be
+ *                                     confirmed at the end of data must agree with it,can be RT_NULL
+ * @param {uint32_t} *offset offset of the sync,or bytes that can be dropped if none is found
+ * @return the error code,RT_EOK if a sync is found
+ */
+rt_err_t mp3_frame_sync(const uint8_t *buf, uint32_t len, uint8_t eof, const mp3_frame_header_t *ref, uint32_t *offset)
+{
+    mp3_frame_header_t candidate, header;
+    const uint8_t *p;
+    uint32_t i, next, confirmed;
+
+    for (i = 0; i + MP3_FRAME_HEADER_SIZE <= len; i++)
+    {
+        p = memchr(buf + i, 0xFF, len - MP3_FRAME_HEADER_SIZE + 1 - i);
+        if (p == RT_NULL)
+            break;
+        i = p - buf;
+        if (mp3_frame_header_parse(p, &candidate) != RT_EOK)
+            continue;
+
+        /* headers at the computed frame lengths must agree with the candidate */
+        confirmed = 0;
+        next = i + candidate.frame_size;
+        while (confirmed < MP3_SYNC_CONFIRM_FRAMES && next + MP3_FRAME_HEADER_SIZE <= len)
+        {
+            if (mp3_frame_header_parse(buf + next, &header) != RT_EOK ||
+                !mp3_frame_header_match(&candidate, &header))
+                break;
+            confirmed++;
+            next += header.frame_size;
+        }
+        if (confirmed == MP3_SYNC_CONFIRM_FRAMES)
+            goto __found;
+        if (next + MP3_FRAME_HEADER_SIZE <= len)
+            continue; /* false sync */
+
+        /* buf ends before the check does */
+        if (i > 0 && !eof)
+        {
+            /* drop up to the candidate,it is checked again with more data behind it */
+            *offset = i;
+            return RT_ERROR;
+        }
+        if (confirmed > 0 || (eof && (ref == RT_NULL || mp3_frame_header_match(ref, &candidate))))
+            goto __found;
+        if (!eof)
+        {
+            /* frame is longer than buf,wait for more data */
+            *offset = 0;
+            return RT_ERROR;
+        }
+    }
+
+    /* keep a partial header,it may be completed by the next data */
+    *offset = eof ? len : (len >= MP3_FRAME_HEADER_SIZE ? len - (MP3_FRAME_HEADER_SIZE - 1) : 0);
+    return RT_ERROR;
+
+__found:
+    *offset = i;
+    return RT_EOK;
+}
+
+/**
+ * @description: walk frame headers without decoding
+ * @param {mp3_file_t} fp
+ * @param {uint32_t} offset file offset of the first frame
+ * @param {uint32_t} end file offset where audio data ends
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size, no less than 512 bytes
+ * @param {mp3_frame_walk_cb} cb called for every frame
+ * @param {void} *user
+ * @param {volatile rt_uint8_t} *cancel walk stops when it becomes non-zero,can be RT_NULL
+ * @return frames walked
+ */
+uint32_t mp3_frame_walk(mp3_file_t fp, uint32_t offset, uint32_t end, uint8_t *buf, uint32_t size,
+                        mp3_frame_walk_cb cb, void *user, volatile rt_uint8_t *cancel)
+{
+    mp3_frame_header_t header;
+    uint32_t frames = 0;
+    uint32_t pos = offset;
+    uint32_t buf_pos = offset; /* file offset of buf[0] */
+    uint32_t buf_len = 0;      /* valid bytes in buf */
+    long file_pos = -1;        /* current file position, -1 if unknown */
+
+    while (pos + MP3_FRAME_HEADER_SIZE <= end)
+    {
+        if (cancel && *cancel)
+            break;
+
+        if (pos < buf_pos || pos + MP3_FRAME_HEADER_SIZE > buf_pos + buf_len)
+        {
+            /* header is not buffered, read a new block from it */
+            if (file_pos != (long)pos && mp3_file_seek(fp, pos, SEEK_SET) != 0)
+                break;
+            buf_len = mp3_file_read(fp, buf, MIN(size, end - pos));
+            buf_pos = pos;
+            file_pos = pos + buf_len;
+            if (buf_len < MP3_FRAME_HEADER_SIZE)
+                break;
+        }
+
+        if (mp3_frame_header_parse(buf + (pos - buf_pos), &header) != RT_EOK)
+        {
+            /* lost sync, scan forward */
+            pos++;
+            continue;
+        }
+
+        if (cb && cb(user, frames, pos, &header) != RT_EOK)
+            break;
+        frames++;
+        pos += header.frame_size;
+    }
+
+    return frames;
+}
+
+/* main data bytes a layer III frame may take from the frames before it */
+#define MP3_RESERVOIR_SIZE (511)
+/* header,crc and the largest side info,bytes of a frame that are not main data */
+#define MP3_FRAME_OVERHEAD (4 + 2 + 32)
+
+struct frame_preroll
+{
+    uint32_t frames;
+    uint32_t walked; /* frames counted,false syncs are not */
+    uint32_t last;   /* last frame counted */
+    mp3_frame_header_t first; /* header of the start frame */
+    uint32_t offset[MP3_PREROLL_FRAMES_MAX + 1]; /* offsets of the last frames counted */
+};
+
+/* frames are filtered like the seek index,so the count from an entry lands on the indexed frame */
+static rt_err_t mp3_frame_preroll_cb(void *user, uint32_t frame, uint32_t offset, const mp3_frame_header_t *header)
+{
+    struct frame_preroll *preroll = (struct frame_preroll *)user;
+
+    if (preroll->walked == 0)
+        preroll->first = *header;
+    else if (!mp3_frame_header_match(&preroll->first, header))
+        return RT_EOK; /* false sync in damaged data,not counted */
+
+    frame = preroll->walked++;
+    preroll->offset[frame % (MP3_PREROLL_FRAMES_MAX + 1)] = offset;
+    preroll->last = frame;
+    return (frame < preroll->frames) ? RT_EOK : RT_ERROR;
+}
+
+/**
+ * @description: locate the frame that is a number of frames after a given frame,
+ *               then back up over the frames that hold its bit reservoir
+ * @param {mp3_file_t} fp
+ * @param {uint32_t} offset file offset of the start frame
+ * @param {uint32_t} frames frames to skip,headers that do not match the start frame are not counted
+ * @param {uint32_t} *preroll frames before the located one that are decoded but not played
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size
+ * @return file offset of the first preroll frame
+ */
+uint32_t mp3_frame_locate_preroll(mp3_file_t fp, uint32_t offset, uint32_t frames, uint32_t *preroll,
+                                  uint8_t *buf, uint32_t size)
+{
+    struct frame_preroll walk;
+    uint32_t ring = MP3_PREROLL_FRAMES_MAX + 1;
+    uint32_t last, prev, max, k;
+
+    *preroll = 0;
+    if (frames == 0)
+        return offset;
+
+    walk.frames = frames;
+    walk.walked = 0;
+    walk.last = 0;
+    walk.offset[0] = offset;
+    mp3_frame_walk(fp, offset, UINT32_MAX, buf, size, mp3_frame_preroll_cb, &walk, RT_NULL);
+    last = walk.last;
+    if (last == 0)
+        return offset;
+
+    /*
+     * the frame before the target must decode,or the target overlaps stale
+     * samples, so its main data and reservoir have to be inside the preroll
+     */
+    max = MIN(last, MP3_PREROLL_FRAMES_MAX);
+    prev = walk.offset[(last - 1) % ring];
+    for (k = 1; k < max; k++)
+    {
+        if (prev - walk.offset[(last - 1 - k) % ring] >= MP3_RESERVOIR_SIZE + k * MP3_FRAME_OVERHEAD)
+            break;
+    }
+    /* k frames hold the reservoir of the frame before the target,which is one more */
+    k = MIN(k + 1, max);
+
+    *preroll = k;
+    return walk.offset[(last - k) % ring];
+}
@@ -0,0 +1,732 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_id3v2.h"
+#include <rtthread.h>
+#include <string.h>
+
+#define LOG_TAG "mp3 id3v2"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define ID3V2_HEADER_SIZE (10)
+
+#define ID3V2_FLAG_UNSYNC (0x80)
+#define ID3V2_FLAG_EXTENDED (0x40) /* v2.2: compression */
+#define ID3V2_FLAG_FOOTER (0x10)   /* v2.4 only */
+
+#define ID3V2_ENC_LATIN1 (0)
+#define ID3V2_ENC_UTF16 (1) /* with BOM */
+#define ID3V2_ENC_UTF16BE (2)
+#define ID3V2_ENC_UTF8 (3)
+
+#define ID3V2_SYNCSAFE(p) (((uint32_t)((p)[0] & 0x7f) << 21) | ((uint32_t)((p)[1] & 0x7f) << 14) | ((uint32_t)((p)[2] & 0x7f) << 7) | ((p)[3] & 0x7f))
+#define ID3V2_BE24(p) (((uint32_t)(p)[0] << 16) | ((uint32_t)(p)[1] << 8) | (p)[2])
+#define ID3V2_BE32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (p)[3])
+
+enum ID3V2_FRAME_TYPE
+{
+    ID3V2_FRAME_TITLE = 0,
+    ID3V2_FRAME_ARTIST,
+    ID3V2_FRAME_ALBUM,
+    ID3V2_FRAME_TRACK,
+    ID3V2_FRAME_YEAR,
+    ID3V2_FRAME_GENRE,
+    ID3V2_FRAME_LENGTH,
+    ID3V2_FRAME_COMMENT,
+    ID3V2_FRAME_TXXX,
+    ID3V2_FRAME_PICTURE,
+};
+
+/*
+ * frames decoded,v2.2 uses 3 character ids
+ */
+static const struct
+{
+    char id[5];
+    char id22[4];
+    uint8_t type;
+} mp3_id3v2_frames[] =
+{
+    {"TIT2", "TT2", ID3V2_FRAME_TITLE},
+    {"TPE1", "TP1", ID3V2_FRAME_ARTIST},
+    {"TALB", "TAL", ID3V2_FRAME_ALBUM},
+    {"TRCK", "TRK", ID3V2_FRAME_TRACK},
+    {"TYER", "TYE", ID3V2_FRAME_YEAR},
+    {"TDRC", "", ID3V2_FRAME_YEAR}, /* v2.4 recording time */
+    {"TCON", "TCO", ID3V2_FRAME_GENRE},
+    {"TLEN", "TLE", ID3V2_FRAME_LENGTH},
+    {"COMM", "COM", ID3V2_FRAME_COMMENT},
+    {"TXXX", "TXX", ID3V2_FRAME_TXXX},
+    {"APIC", "PIC", ID3V2_FRAME_PICTURE},
+};
+
+/*
+ * tag reader,the tag is read through a window in large reads
+ */
+struct mp3_id3v2_reader
+{
+    mp3_file_t fp;
+    uint8_t *buf;    /* window */
+    uint32_t size;   /* window size */
+    uint32_t base;   /* file offset of buf[0] */
+    uint32_t pos;    /* read position in window */
+    uint32_t len;    /* bytes in window */
+    uint32_t remain; /* tag bytes not loaded yet */
+    uint32_t budget; /* file bytes still allowed to be read */
+
+    uint8_t version; /* tag major version */
+    uint32_t left;   /* bytes left in the current frame */
+    uint8_t raw;     /* left counts bytes before removing unsynchronisation (v2.4) */
+    uint8_t unsync;  /* remove unsynchronisation */
+    uint8_t last;    /* last byte read,0xff 0x00 is unsynchronised to 0xff */
+};
+
+/**
+ * @description: get whole tag size from the ID3v2 header
+ * @param {const uint8_t} *header first 10 bytes of the file
+ * @return {uint32_t} whole tag size with header and footer,0 if there is no tag
+ */
+uint32_t mp3_id3v2_tag_size(const uint8_t *header)
+{
+    const ID3V2_TagHead_t *head = (const ID3V2_TagHead_t *)header;
+    uint32_t size;
+
+    if (strncmp("ID3", (const char *)head->id, 3) != 0)
+        return 0;
+
+    size = ID3V2_SYNCSAFE(head->size) + ID3V2_HEADER_SIZE; /* header included */
+    if (head->mversion == 4 && (head->flags & ID3V2_FLAG_FOOTER))
+        size += ID3V2_HEADER_SIZE; /* footer present */
+
+    return size;
+}
+
+/**
+ * @description: read next byte of the tag,the window is refilled when empty
+ * @param {struct mp3_id3v2_reader} *r
+ * @return byte,-1 at end of tag or read budget
+ */
+static int mp3_id3v2_getc(struct mp3_id3v2_reader *r)
+{
+    uint32_t size;
+
+    if (r->pos == r->len)
+    {
+        size = MIN(MIN(r->size, r->remain), r->budget);
+        if (size == 0)
+            return -1;
+        size = mp3_file_read(r->fp, r->buf, size);
+        if (size == 0)
+        {
+            r->remain = 0;
+            return -1;
+        }
+        r->base += r->len;
+        r->pos = 0;
+        r->len = size;
+        r->remain -= size;
+        r->budget -= size;
+    }
+
+    return r->buf[r->pos++];
+}
+
+/**
+ * @description: read next byte of the current frame,unsynchronisation removed
+ * @param {struct mp3_id3v2_reader} *r
+ * @return byte,-1 at end of frame
+ */
+static int mp3_id3v2_getb(struct mp3_id3v2_reader *r)
+{
+    int c;
+
+    if (r->left == 0)
+        return -1;
+
+    c = mp3_id3v2_getc(r);
+    if (c == 0x00 && r->unsync && r->last == 0xff)
+    {
+        /* drop the zero inserted after 0xff */
+        if (r->raw && --r->left == 0)
+            return -1;
+        c = mp3_id3v2_getc(r);
+    }
+    if (c < 0)
+    {
+        r->left = 0;
+        return -1;
+    }
+    r->left--;
+    r->last = c;
+
+    return c;
+}
+
+/**
+ * @description: read next utf-16 code unit of the current frame
+ * @param {struct mp3_id3v2_reader} *r
+ * @param {uint8_t} be big endian
+ * @return code unit,-1 at end of frame
+ */
+static int mp3_id3v2_getw(struct mp3_id3v2_reader *r, uint8_t be)
+{
+    int a, b;
+
+    if ((a = mp3_id3v2_getb(r)) < 0 || (b = mp3_id3v2_getb(r)) < 0)
+        return -1;
+
+    return be ? (a << 8) | b : (b << 8) | a;
+}
+
+/**
+ * @description: skip the rest of the current frame,large frames are skipped
+ *               with one seek instead of reading them through the window
+ * @param {struct mp3_id3v2_reader} *r
+ * @return None
+ */
+static void mp3_id3v2_skip(struct mp3_id3v2_reader *r)
+{
+    uint32_t size;
+
+    if (r->unsync && !r->raw)
+    {
+        /* frame size counts bytes after removing unsynchronisation, scan them */
+        while (mp3_id3v2_getb(r) >= 0)
+            ;
+        return;
+    }
+
+    size = MIN(r->left, r->len - r->pos);
+    r->pos += size;
+    r->left -= size;
+    if (r->left == 0)
+        return;
+
+    if (r->left > r->remain || mp3_file_seek(r->fp, r->left, SEEK_CUR) != 0)
+    {
+        /* frame runs past the tag */
+        r->remain = 0;
+    }
+    else
+    {
+        r->base += r->left;
+        r->remain -= r->left;
+    }
+    r->left = 0;
+}
+
+/**
+ * @description: read a string of the current frame,utf-16 and utf-8 are stored as utf-8,
+ *               ISO-8859-1 is copied as is since many tags store a local code page there
+ * @param {struct mp3_id3v2_reader} *r
+ * @param {uint8_t} enc text encoding of the frame
+ * @param {uint8_t} *dst RT_NULL to drop the string
+ * @param {uint32_t} size dst size,the string is cut at a character boundary and zero terminated
+ * @return None
+ */
+static void mp3_id3v2_text(struct mp3_id3v2_reader *r, uint8_t enc, uint8_t *dst, uint32_t size)
+{
+    uint8_t seq[4];
+    uint8_t be = (enc == ID3V2_ENC_UTF16BE);
+    uint8_t full = (dst == RT_NULL || size == 0);
+    uint32_t len = 0, n, i;
+    int c, lo, first = -1;
+
+    if (enc == ID3V2_ENC_UTF16)
+    {
+        c = mp3_id3v2_getw(r, 0);
+        if (c == 0xfffe)
+            be = 1;
+        else if (c != 0xfeff)
+            first = c; /* no BOM,assume little endian */
+    }
+
+    while (1)
+    {
+        if (enc == ID3V2_ENC_UTF16 || enc == ID3V2_ENC_UTF16BE)
+        {
+            c = first >= 0 ? first : mp3_id3v2_getw(r, be);
+            first = -1;
+            if (c <= 0)
+                break;
+            if (c >= 0xd800 && c < 0xdc00)
+            {
+                /* surrogate pair */
+                lo = mp3_id3v2_getw(r, be);
+                if (lo <= 0)
+                    break;
+                c = (lo >= 0xdc00 && lo < 0xe000) ? 0x10000 + ((c - 0xd800) << 10) + (lo - 0xdc00) : '?';
+            }
+            if (c < 0x80)
+            {
+                seq[0] = c;
+                n = 1;
+            }
+            else if (c < 0x800)
+            {
+                seq[0] = 0xc0 | (c >> 6);
+                seq[1] = 0x80 | (c & 0x3f);
+                n = 2;
+            }
+            else if (c < 0x10000)
+            {
+                seq[0] = 0xe0 | (c >> 12);
+                seq[1] = 0x80 | ((c >> 6) & 0x3f);
+                seq[2] = 0x80 | (c & 0x3f);
+                n = 3;
+            }
+            else
+            {
+                seq[0] = 0xf0 | (c >> 18);
+                seq[1] = 0x80 | ((c >> 12) & 0x3f);
+                seq[2] = 0x80 | ((c >> 6) & 0x3f);
+                seq[3] = 0x80 | (c & 0x3f);
+                n = 4;
+            }
+        }
+        else
+        {
+            c = mp3_id3v2_getb(r);
+            if (c <= 0)
+                break;
+            seq[0] = c;
+            n = 1;
+            if (enc == ID3V2_ENC_UTF8)
+            {
+                /* keep multibyte sequences whole */
+                n = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+                for (i = 1; i < n; i++)
+                {
+                    c = mp3_id3v2_getb(r);
+                    if (c <= 0)
+                        break;
+                    seq[i] = c;
+                }
+                if (i < n)
+                    break;
+            }
+        }
+
+        if (!full)
+        {
+            if (len + n < size)
+            {
+                memcpy(dst + len, seq, n);
+                len += n;
+            }
+            else
+            {
+                full = 1; /* keep reading up to the terminator */
+            }
+        }
+    }
+
+    if (dst != RT_NULL && size > 0)
+        dst[len] = 0;
+}
+
+/**
+ * @description: parse decimal number
+ * @param {const uint8_t} *text
+ * @return {uint32_t} number
+ */
+static uint32_t mp3_id3v2_number(const uint8_t *text)
+{
+    uint32_t value = 0;
+
+    while (*text >= '0' && *text <= '9')
+        value = value * 10 + (*text++ - '0');
+
+    return value;
+}
+
+/**
+ * @description: convert TCON genre text,"(17)","17" and "(17)Refinement" give the ID3v1 genre id
+ * @param {mp3_basic_info_t} *basic_info
+ * @return None
+ */
+static void mp3_id3v2_genre(mp3_basic_info_t *basic_info)
+{
+    uint8_t *text = basic_info->genre_text;
+    uint8_t *p = text;
+    uint8_t paren = (*p == '(');
+    uint32_t id;
+
+    if (paren)
+        p++;
+    if (*p < '0' || *p > '9')
+        return; /* genre name */
+    id = mp3_id3v2_number(p);
+    while (*p >= '0' && *p <= '9')
+        p++;
+    if (paren && *p++ != ')')
+        return;
+    if ((!paren && *p != 0) || id > 147)
+        return;
+
+    basic_info->genre = id;
+    memmove(text, p, strlen((char *)p) + 1); /* keep refinement only */
+}
+
+/**
+ * @description: get frame type from frame id
+ * @param {const uint8_t} *id
+ * @param {uint8_t} version tag major version
+ * @return frame type,-1 if the frame is not decoded
+ */
+static int mp3_id3v2_frame_type(const uint8_t *id, uint8_t version)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(mp3_id3v2_frames) / sizeof(mp3_id3v2_frames[0]); i++)
+    {
+        if (version == 2 ? memcmp(id, mp3_id3v2_frames[i].id22, 3) == 0
+                         : memcmp(id, mp3_id3v2_frames[i].id, 4) == 0)
+            return mp3_id3v2_frames[i].type;
+    }
+
+    return -1;
+}
+
+/**
+ * @description: decode body of a text frame
+ * @param {struct mp3_id3v2_reader} *r
+ * @param {int} type frame type
+ * @param {mp3_basic_info_t} *basic_info
+ * @return None
+ */
+static void mp3_id3v2_frame_decode(struct mp3_id3v2_reader *r, int type, mp3_basic_info_t *basic_info)
+{
+    uint8_t text[16];
+    mp3_txxx_t *txxx;
+    mp3_picture_t *picture;
+    uint32_t i;
+    int enc, c;
+
+    enc = mp3_id3v2_getb(r);
+    if (enc < 0)
+        return;
+
+    switch (type)
+    {
+    case ID3V2_FRAME_TITLE:
+        mp3_id3v2_text(r, enc, basic_info->title, sizeof(basic_info->title));
+        break;
+    case ID3V2_FRAME_ARTIST:
+        mp3_id3v2_text(r, enc, basic_info->artist, sizeof(basic_info->artist));
+        break;
+    case ID3V2_FRAME_ALBUM:
+        mp3_id3v2_text(r, enc, basic_info->album, sizeof(basic_info->album));
+        break;
+    case ID3V2_FRAME_TRACK:
+        mp3_id3v2_text(r, enc, basic_info->track, sizeof(basic_info->track));
+        break;
+    case ID3V2_FRAME_YEAR:
+        /* TDRC is "yyyy-MM-ddTHH:mm:ss", keep the year */
+        mp3_id3v2_text(r, enc, text, sizeof(text));
+        if (strlen((char *)text) >= 4)
+            memcpy(basic_info->year, text, 4);
+        break;
+    case ID3V2_FRAME_GENRE:
+        mp3_id3v2_text(r, enc, basic_info->genre_text, sizeof(basic_info->genre_text));
+        mp3_id3v2_genre(basic_info);
+        break;
+    case ID3V2_FRAME_LENGTH:
+        mp3_id3v2_text(r, enc, text, sizeof(text));
+        basic_info->length_ms = mp3_id3v2_number(text);
+        break;
+    case ID3V2_FRAME_COMMENT:
+        /* language,short description,text. only the comment without description is kept */
+        mp3_id3v2_getb(r);
+        mp3_id3v2_getb(r);
+        mp3_id3v2_getb(r);
+        mp3_id3v2_text(r, enc, text, sizeof(text));
+        if (text[0] == 0)
+            mp3_id3v2_text(r, enc, basic_info->comment, sizeof(basic_info->comment));
+        break;
+    case ID3V2_FRAME_TXXX:
+        if (basic_info->txxx_count >= MP3_TXXX_MAX)
+            break;
+        txxx = &basic_info->txxx[basic_info->txxx_count++];
+        mp3_id3v2_text(r, enc, txxx->desc, sizeof(txxx->desc));
+        mp3_id3v2_text(r, enc, txxx->value, sizeof(txxx->value));
+        break;
+    case ID3V2_FRAME_PICTURE:
+        /* unsynchronised image bytes are not contiguous in the file, they can not be streamed */
+        if (r->unsync || basic_info->picture_count >= MP3_PICTURE_MAX)
+            break;
+        picture = &basic_info->picture[basic_info->picture_count];
+        if (r->version == 2)
+        {
+            /* v2.2 has a 3 character image format instead of the mime type */
+            for (i = 0; i < 3; i++)
+            {
+                c = mp3_id3v2_getb(r);
+                text[i] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+            }
+            text[3] = 0;
+            rt_snprintf((char *)picture->mime, sizeof(picture->mime), "image/%s",
+                        strcmp((char *)text, "jpg") == 0 ? "jpeg" : (char *)text);
+        }
+        else
+        {
+            mp3_id3v2_text(r, ID3V2_ENC_LATIN1, picture->mime, sizeof(picture->mime));
+        }
+        if ((c = mp3_id3v2_getb(r)) < 0)
+            break;
+        picture->type = c;
+        mp3_id3v2_text(r, enc, RT_NULL, 0); /* description */
+        if (r->left == 0)
+            break;
+        /* image data is the rest of the frame */
+        picture->offset = r->base + r->pos;
+        picture->length = r->left;
+        basic_info->picture_count++;
+        LOG_D("picture type %d %s %d bytes at %d", picture->type, picture->mime, picture->length, picture->offset);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @description: parse ID3v2.2/2.3/2.4 tag at the file start,the tag is streamed through buf,
+ *               no memory is allocated
+ * @param {mp3_file_t} fp
+ * @param {mp3_basic_info_t} *basic_info only fields found in the tag are written
+ * @param {uint8_t} *buf window the tag is read through
+ * @param {uint32_t} size window size,no less than 16 bytes
+ * @return {uint32_t} whole tag size,0 if there is no tag
+ */
+uint32_t mp3_id3v2_parse(mp3_file_t fp, mp3_basic_info_t *basic_info, uint8_t *buf, uint32_t size)
+{
+    struct mp3_id3v2_reader r;
+    ID3V2_TagHead_t head;
+    uint8_t frame[10];
+    uint32_t ret = 0;
+    uint32_t frame_size, head_size, id_size, i;
+    uint8_t version, frame_flags, tag_unsync;
+    int type, c;
+    long file_pos;
+    rt_tick_t start, timeout;
+
+    if (fp == MP3_FILE_NULL || basic_info == RT_NULL || buf == RT_NULL || size < 16)
+        return 0;
+
+    file_pos = mp3_file_tell(fp); /* save current file positon */
+
+    if (mp3_file_seek(fp, 0, SEEK_SET) != 0 || mp3_file_read(fp, &head, ID3V2_HEADER_SIZE) != ID3V2_HEADER_SIZE)
+        goto __exit;
+    ret = mp3_id3v2_tag_size((uint8_t *)&head);
+    if (ret == 0)
+        goto __exit;
+    LOG_D("tag v2.%d size:%d", head.mversion, ret);
+
+    version = head.mversion;
+    if (version < 2 || version > 4)
+        goto __exit; /* unknown version,only its size is used */
+    if (version == 2 && (head.flags & ID3V2_FLAG_EXTENDED))
+        goto __exit; /* v2.2 compression,no scheme was ever defined */
+
+    memset(&r, 0, sizeof(r));
+    r.fp = fp;
+    r.buf = buf;
+    r.size = size;
+    r.remain = ID3V2_SYNCSAFE(head.size);
+    r.base = ID3V2_HEADER_SIZE;
+    r.budget = MP3_ID3V2_READ_BUDGET;
+    r.version = version;
+    /* v2.2/v2.3 unsynchronise the whole tag,v2.4 each frame */
+    tag_unsync = head.flags & ID3V2_FLAG_UNSYNC;
+
+    /* skip the extended header, if present */
+    if (version >= 3 && (head.flags & ID3V2_FLAG_EXTENDED))
+    {
+        r.unsync = tag_unsync && version == 3;
+        r.left = 4;
+        for (i = 0; i < 4; i++)
+        {
+            if ((c = mp3_id3v2_getb(&r)) < 0)
+                goto __exit;
+            frame[i] = c;
+        }
+        /* v2.3 size excludes itself,v2.4 size is syncsafe and includes itself */
+        frame_size = version == 3 ? ID3V2_BE32(frame) : ID3V2_SYNCSAFE(frame);
+        if (version == 4 && frame_size < 4)
+            goto __exit;
+        r.left = version == 3 ? frame_size : frame_size - 4;
+        mp3_id3v2_skip(&r);
+    }
+
+    start = rt_tick_get();
+    timeout = rt_tick_from_millisecond(MP3_ID3V2_TIME_BUDGET_MS);
+    head_size = version == 2 ? 6 : 10;
+    id_size = version == 2 ? 3 : 4;
+    while (1)
+    {
+        if (rt_tick_get() - start > timeout)
+        {
+            LOG_W("tag frames not parsed,time budget used up");
+            break;
+        }
+
+        /* frame header */
+        r.unsync = tag_unsync && version < 4;
+        r.raw = 0;
+        r.left = head_size;
+        for (i = 0; i < head_size; i++)
+        {
+            if ((c = mp3_id3v2_getb(&r)) < 0)
+                break;
+            frame[i] = c;
+        }
+        if (i < head_size || frame[0] == 0)
+            break; /* end of tag or padding */
+        for (i = 0; i < id_size; i++)
+        {
+            if (!((frame[i] >= 'A' && frame[i] <= 'Z') || (frame[i] >= '0' && frame[i] <= '9')))
+                break;
+        }
+        if (i < id_size)
+            break; /* not a frame id,garbage after the frames */
+
+        type = mp3_id3v2_frame_type(frame, version);
+        if (version == 2)
+        {
+            frame_size = ID3V2_BE24(frame + 3);
+            frame_flags = 0;
+        }
+        else if (version == 3 || ((frame[4] | frame[5] | frame[6] | frame[7]) & 0x80))
+        {
+            /* some v2.4 writers store plain sizes,they are never syncsafe */
+            frame_size = ID3V2_BE32(frame + 4);
+            frame_flags = frame[9];
+        }
+        else
+        {
+            frame_size = ID3V2_SYNCSAFE(frame + 4);
+            frame_flags = frame[9];
+        }
+
+        /* frame body */
+        r.left = frame_size;
+        if (version == 4)
+        {
+            r.raw = 1;
+            r.unsync = tag_unsync || (frame_flags & 0x02);
+            r.last = 0;
+            if (frame_flags & 0x0C)
+            {
+                type = -1; /* compressed or encrypted */
+            }
+            else
+            {
+                if (frame_flags & 0x40)
+                    mp3_id3v2_getb(&r); /* group id */
+                if (frame_flags & 0x01)
+                {
+                    for (i = 0; i < 4; i++)
+                        mp3_id3v2_getb(&r); /* data length indicator */
+                }
+            }
+        }
+        else if (version == 3)
+        {
+            if (frame_flags & 0xC0)
+                type = -1; /* compressed or encrypted */
+            else if (frame_flags & 0x20)
+                mp3_id3v2_getb(&r); /* group id */
+        }
+
+        if (type >= 0)
+            mp3_id3v2_frame_decode(&r, type, basic_info);
+        mp3_id3v2_skip(&r);
+    }
+    if (r.remain && r.budget == 0)
+        LOG_W("tag frames not parsed,read budget used up");
+
+__exit:
+    mp3_file_seek(fp, file_pos, SEEK_SET); /* resume file positon */
+    return ret;
+}
+
+/**
+ * @description: read a chunk of an embedded picture
+ * @param {mp3_file_t} fp file the picture was found in
+ * @param {const mp3_picture_t} *picture
+ * @param {uint32_t} pos offset in the image
+ * @param {uint8_t} *buf
+ * @param {uint32_t} size buf size
+ * @return {uint32_t} bytes read,0 at the end of image or on error
+ */
+uint32_t mp3_picture_read(mp3_file_t fp, const mp3_picture_t *picture, uint32_t pos, uint8_t *buf, uint32_t size)
+{
+    if (fp == MP3_FILE_NULL || picture == RT_NULL || buf == RT_NULL || pos >= picture->length)
+        return 0;
+
+    if (mp3_file_seek(fp, picture->offset + pos, SEEK_SET) != 0)
+        return 0;
+
+    return mp3_file_read(fp, buf, MIN(size, picture->length - pos));
+}
+
+/**
+ * @description: stream an embedded picture to a callback in fixed size chunks,
+ *               the file is opened separately so playback of it goes on
+ * @param {const char} *path file the picture was found in
+ * @param {const mp3_picture_t} *picture
+ * @param {uint8_t} *buf chunk buffer
+ * @param {uint32_t} size chunk size
+ * @param {mp3_picture_cb_t} cb called for every chunk
+ * @param {void} *user passed to cb
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_picture_stream(const char *path, const mp3_picture_t *picture, uint8_t *buf, uint32_t size,
+                            mp3_picture_cb_t cb, void *user)
+{
+    mp3_file_t fp;
+    uint32_t pos = 0, read_size;
+    rt_err_t ret = RT_EOK;
+
+    if (path == RT_NULL || picture == RT_NULL || buf == RT_NULL || size == 0 || cb == RT_NULL)
+        return RT_ERROR;
+
+    fp = mp3_file_open(path);
+    if (fp == MP3_FILE_NULL)
+    {
+        LOG_E("open %s failed", path);
+        return RT_ERROR;
+    }
+
+    if (mp3_file_seek(fp, picture->offset, SEEK_SET) != 0)
+    {
+        ret = RT_ERROR;
+        goto __exit;
+    }
+    while (pos < picture->length)
+    {
+        read_size = mp3_file_read(fp, buf, MIN(size, picture->length - pos));
+        if (read_size == 0)
+        {
+            ret = RT_ERROR; /* file is shorter than the tag says */
+            goto __exit;
+        }
+        ret = cb(buf, read_size, user);
+        if (ret != RT_EOK)
+            goto __exit;
+        pos += read_size;
+    }
+
+__exit:
+    mp3_file_close(fp);
+    return ret;
+}
@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_input.h"
+#include <string.h>
+
+#define LOG_TAG "mp3 input"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/**
+ * @description: init input ring
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} size min ring size,rounded up to a power of two
+ * @param {uint32_t} block_size refill unit,power of two
+ * @param {uint32_t} mirror_size max contiguous window needed by the consumer
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_input_init(struct mp3_input *in, uint32_t size, uint32_t block_size, uint32_t mirror_size)
+{
+    uint32_t ring_size = block_size;
+
+    memset(in, 0, sizeof(struct mp3_input));
+    if (block_size == 0 || (block_size & (block_size - 1)))
+        return -RT_EINVAL;
+
+    /* a whole block must still be free while a full window is buffered */
+    if (size < mirror_size + block_size)
+        size = mirror_size + block_size;
+    while (ring_size < size)
+        ring_size <<= 1;
+
+    in->buffer = rt_malloc(ring_size + mirror_size);
+    if (in->buffer == RT_NULL)
+    {
+        LOG_E("can not malloc input ring for mp3 player.");
+        return -RT_ENOMEM;
+    }
+    in->size = ring_size;
+    in->block_size = block_size;
+    in->mirror_size = mirror_size;
+    mp3_input_reset(in, 0);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: free input ring
+ * @param {struct mp3_input} *in
+ * @return None
+ */
+void mp3_input_deinit(struct mp3_input *in)
+{
+    rt_free(in->buffer);
+    in->buffer = RT_NULL;
+}
+
+/**
+ * @description: drop all data,next data produced comes from a file offset
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} file_offset keeps reads aligned to blocks of the file
+ * @return None
+ */
+void mp3_input_reset(struct mp3_input *in, uint32_t file_offset)
+{
+    in->head = file_offset & (in->block_size - 1);
+    in->tail = in->head;
+    in->eof = 0;
+}
+
+/**
+ * @description: get buffered bytes
+ * @param {struct mp3_input} *in
+ * @return buffered bytes
+ */
+uint32_t mp3_input_used(struct mp3_input *in)
+{
+    return in->head - in->tail;
+}
+
+/**
+ * @description: get space for the next read,only when a whole block is free
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} *len contiguous free bytes,ending on a block boundary
+ * @return write pointer,RT_NULL if ring is full
+ */
+uint8_t *mp3_input_write_ptr(struct mp3_input *in, uint32_t *len)
+{
+    uint32_t head = in->head;
+    uint32_t space = in->size - (head - in->tail);
+    uint32_t pos = head & (in->size - 1);
+
+    if (space < in->block_size)
+        return RT_NULL;
+
+    /* one read up to the ring end, trimmed so the next read starts on a block */
+    space = MIN(space, in->size - pos);
+    *len = ((pos + space) & ~(in->block_size - 1)) - pos;
+    return in->buffer + pos;
+}
+
+/**
+ * @description: publish bytes written to the write pointer
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} len
+ * @return None
+ */
+void mp3_input_produce(struct mp3_input *in, uint32_t len)
+{
+    uint32_t pos = in->head & (in->size - 1);
+
+    /* keep the mirror in step with the ring head */
+    if (pos < in->mirror_size)
+        memcpy(in->buffer + in->size + pos, in->buffer + pos, MIN(len, in->mirror_size - pos));
+
+    in->head += len;
+}
+
+/**
+ * @description: get contiguous window of buffered data
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} *len contiguous bytes,at least min(buffered,mirror_size)
+ * @return read pointer
+ */
+uint8_t *mp3_input_read_ptr(struct mp3_input *in, uint32_t *len)
+{
+    uint32_t pos = in->tail & (in->size - 1);
+    uint32_t used = in->head - in->tail;
+    uint32_t contiguous = in->size + in->mirror_size - pos;
+
+    *len = MIN(used, contiguous);
+    return in->buffer + pos;
+}
+
+/**
+ * @description: drop bytes from the read pointer
+ * @param {struct mp3_input} *in
+ * @param {uint32_t} len
+ * @return None
+ */
+void mp3_input_consume(struct mp3_input *in, uint32_t len)
+{
+    in->tail += len;
+}
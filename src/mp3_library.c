@@ -0,0 +1,623 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_library.h"
+#include "mp3_player.h"
+#include "mp3_cache.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define LOG_TAG "mp3 library"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#define MP3_LIBRARY_VERSION (1)
+#define MP3_LIBRARY_NONE (0xFFFFFFFF)
+#define MP3_LIBRARY_TMP_PATH MP3_LIBRARY_INDEX_PATH ".tmp"
+
+#define MP3_LIBRARY_THREAD_STACK_SIZE (1024 * 4)
+#define MP3_LIBRARY_THREAD_PRIORITY (26) /* below the player background thread */
+#define MP3_LIBRARY_BUFFER_SIZE (1024 * 2)
+#define MP3_LIBRARY_PAUSE_MS (100) /* poll interval while playback is underrunning */
+
+/*
+ * directory being walked at one level of the tree
+ */
+struct mp3_library_level
+{
+    uint32_t rec;       /* record of the directory in the new index */
+    uint32_t old;       /* record of the directory in the last index,MP3_LIBRARY_NONE if not known */
+    uint32_t old_first; /* children in the last index */
+    uint32_t old_count;
+    uint32_t first;     /* children in the new index */
+    uint32_t count;
+    uint32_t next;      /* next child to walk */
+    uint32_t len;       /* length of lib->path of the directory */
+    rt_bool_t unchanged; /* children were taken from the last index */
+};
+
+/*
+ * scanner structure definition
+ *
+ * the walk is iterative and its records are kept here,so the scanner
+ * stack does not grow with the depth of the tree.
+ */
+struct mp3_library
+{
+    struct rt_mutex lock; /* index file is replaced at the end of a scan */
+    rt_thread_t tid;
+    volatile rt_uint8_t cancel;
+    int old_fd; /* index of the last scan */
+    int new_fd;
+    uint8_t *buf;   /* probe scratch buffer */
+    uint32_t yield; /* files probed since the last sleep */
+    char path[MP3_LIBRARY_PATH_MAX];
+    mp3_info_t info;
+    struct mp3_library_progress progress;
+    struct mp3_library_level level[MP3_LIBRARY_DEPTH_MAX];
+    struct mp3_library_record record; /* scratch records of the walk */
+    struct mp3_library_record child;
+    struct stat st;
+};
+
+static struct mp3_library library;
+
+/**
+ * @description: read an index record
+ * @param {int} fd
+ * @param {uint32_t} index
+ * @param {struct mp3_library_record} *record
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_library_record_read(int fd, uint32_t index, struct mp3_library_record *record)
+{
+    if (lseek(fd, sizeof(struct mp3_library_header) + (long)index * sizeof(struct mp3_library_record), SEEK_SET) < 0 ||
+        read(fd, record, sizeof(struct mp3_library_record)) != sizeof(struct mp3_library_record))
+        return RT_ERROR;
+
+    return RT_EOK;
+}
+
+/**
+ * @description: write an index record
+ * @param {int} fd
+ * @param {uint32_t} index
+ * @param {const struct mp3_library_record} *record
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_library_record_write(int fd, uint32_t index, const struct mp3_library_record *record)
+{
+    if (lseek(fd, sizeof(struct mp3_library_header) + (long)index * sizeof(struct mp3_library_record), SEEK_SET) < 0 ||
+        write(fd, record, sizeof(struct mp3_library_record)) != sizeof(struct mp3_library_record))
+        return RT_ERROR;
+
+    return RT_EOK;
+}
+
+/**
+ * @description: read and check index header
+ * @param {int} fd
+ * @param {struct mp3_library_header} *header
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_library_header_read(int fd, struct mp3_library_header *header)
+{
+    if (lseek(fd, 0, SEEK_SET) < 0 ||
+        read(fd, header, sizeof(struct mp3_library_header)) != sizeof(struct mp3_library_header) ||
+        memcmp(header->magic, "MP3L", 4) != 0 || header->version != MP3_LIBRARY_VERSION)
+        return RT_ERROR;
+
+    return RT_EOK;
+}
+
+/**
+ * @description: check file extension
+ * @param {const char} *name
+ * @return {rt_bool_t} RT_TRUE if name ends with .mp3
+ */
+static rt_bool_t mp3_library_is_mp3(const char *name)
+{
+    const char *ext = strrchr(name, '.');
+    const char *mp3 = ".mp3";
+
+    if (ext == RT_NULL || strlen(ext) != 4)
+        return RT_FALSE;
+    for (; *ext; ext++, mp3++)
+    {
+        if ((*ext | 0x20) != *mp3) /* ascii lower case */
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+/**
+ * @description: keep the scanner off the cpu and the card,
+ *               waits while playback is underrunning and sleeps every few files
+ * @param {struct mp3_library} *lib
+ * @return None
+ */
+static void mp3_library_throttle(struct mp3_library *lib)
+{
+    if (mp3_player_underrun_get())
+    {
+        lib->progress.pauses++;
+        while (mp3_player_underrun_get() && !lib->cancel)
+            rt_thread_mdelay(MP3_LIBRARY_PAUSE_MS);
+    }
+
+    if (++lib->yield >= MP3_LIBRARY_YIELD_FILES)
+    {
+        lib->yield = 0;
+        rt_thread_mdelay(MP3_LIBRARY_YIELD_MS);
+    }
+}
+
+/**
+ * @description: put tags and duration of the file at lib->path into the metadata cache
+ * @param {struct mp3_library} *lib
+ * @return None
+ */
+static void mp3_library_probe(struct mp3_library *lib)
+{
+    struct mp3_cache *cache = mp3_player_cache_get();
+
+    if (cache == RT_NULL)
+        return;
+    if (mp3_cache_get(cache, lib->path, &lib->info) == RT_EOK)
+    {
+        lib->progress.cached++;
+        return;
+    }
+
+    mp3_library_throttle(lib);
+#ifdef MP3_PLAYER_USING_EXACT_DURATION
+    if (mp3_probe_exact(lib->path, &lib->info, lib->buf, MP3_LIBRARY_BUFFER_SIZE, &lib->cancel) == RT_EOK)
+#else
+    if (mp3_probe(lib->path, &lib->info, lib->buf, MP3_LIBRARY_BUFFER_SIZE) == RT_EOK)
+#endif
+        mp3_cache_put(cache, lib->path, &lib->info);
+    lib->progress.files++;
+}
+
+/**
+ * @description: read directory at lib->path into the new index,its entries are
+ *               appended as records [level->first, level->first + level->count),
+ *               a subdirectory that can not be read is kept without entries
+ * @param {struct mp3_library} *lib
+ * @param {struct mp3_library_level} *level rec and old are set by the caller
+ * @param {uint32_t} depth
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_library_read_dir(struct mp3_library *lib, struct mp3_library_level *level, uint32_t depth)
+{
+    struct mp3_library_record *record = &lib->record;
+    struct mp3_library_record *child = &lib->child;
+    DIR *dir;
+    struct dirent *ent;
+    uint32_t old = level->old;
+    uint32_t mtime, len, i;
+    rt_err_t ret = RT_EOK;
+
+    len = strlen(lib->path);
+    level->len = len;
+    level->next = 0;
+    level->unchanged = RT_FALSE;
+    level->old = MP3_LIBRARY_NONE;
+    level->first = lib->progress.records;
+    if (stat(lib->path, &lib->st) != 0)
+    {
+        LOG_W("can not stat %s", lib->path);
+        goto __unreadable;
+    }
+    mtime = lib->st.st_mtime;
+
+    if (old != MP3_LIBRARY_NONE && mp3_library_record_read(lib->old_fd, old, record) == RT_EOK &&
+        record->type == MP3_LIBRARY_DIR)
+    {
+        level->old = old;
+        level->old_first = record->first;
+        level->old_count = record->count;
+        level->unchanged = (record->mtime == mtime);
+    }
+
+    if (level->unchanged)
+    {
+        /* entries did not change,take them from the last index */
+        for (i = 0; i < level->old_count; i++)
+        {
+            if (mp3_library_record_read(lib->old_fd, level->old_first + i, child) != RT_EOK)
+                return RT_ERROR;
+            child->parent = level->rec;
+            if (mp3_library_record_write(lib->new_fd, lib->progress.records, child) != RT_EOK)
+                return RT_ERROR;
+            lib->progress.records++;
+            if (child->type == MP3_LIBRARY_TRACK)
+                lib->progress.tracks++;
+        }
+        lib->progress.dirs_skipped++;
+    }
+    else
+    {
+        dir = opendir(lib->path);
+        if (dir == RT_NULL)
+        {
+            LOG_W("can not open %s", lib->path);
+            goto __unreadable;
+        }
+        while (ret == RT_EOK && !lib->cancel && (ent = readdir(dir)) != RT_NULL)
+        {
+            if (ent->d_name[0] == '.')
+                continue; /* ".", ".." and hidden files */
+            if (strlen(ent->d_name) >= MP3_LIBRARY_NAME_MAX || len + 1 + strlen(ent->d_name) >= MP3_LIBRARY_PATH_MAX)
+            {
+                LOG_W("skip %s/%s,name too long", lib->path, ent->d_name);
+                continue;
+            }
+
+            memset(child, 0, sizeof(struct mp3_library_record));
+            child->parent = level->rec;
+            strcpy(child->name, ent->d_name);
+            if (lib->path[len - 1] != '/')
+                strcat(lib->path, "/");
+            strcat(lib->path, ent->d_name);
+            if (stat(lib->path, &lib->st) == 0 && S_ISDIR(lib->st.st_mode))
+            {
+                if (depth + 1 < MP3_LIBRARY_DEPTH_MAX)
+                    child->type = MP3_LIBRARY_DIR;
+            }
+            else if (mp3_library_is_mp3(ent->d_name))
+            {
+                child->type = MP3_LIBRARY_TRACK;
+                mp3_library_probe(lib);
+            }
+            lib->path[len] = '\0';
+
+            if (child->type == 0)
+                continue;
+            ret = mp3_library_record_write(lib->new_fd, lib->progress.records, child);
+            lib->progress.records++;
+            if (child->type == MP3_LIBRARY_TRACK)
+                lib->progress.tracks++;
+        }
+        closedir(dir);
+        lib->progress.dirs++;
+    }
+    if (ret != RT_EOK || lib->cancel)
+        return RT_ERROR;
+
+__update:
+    level->count = lib->progress.records - level->first;
+    if (mp3_library_record_read(lib->new_fd, level->rec, record) != RT_EOK)
+        return RT_ERROR;
+    record->mtime = mtime;
+    record->first = level->first;
+    record->count = level->count;
+
+    return mp3_library_record_write(lib->new_fd, level->rec, record);
+
+__unreadable:
+    /* the root must be readable,a subdirectory removed or locked during the scan is read again next time */
+    if (depth == 0)
+        return RT_ERROR;
+    mtime = 0;
+    goto __update;
+}
+
+/**
+ * @description: scan directory tree at lib->path,directories are walked depth first
+ *               without recursion,the state of every level is kept in lib->level
+ * @param {struct mp3_library} *lib
+ * @param {uint32_t} old_root record of the root in the last index,MP3_LIBRARY_NONE if not known
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_library_walk(struct mp3_library *lib, uint32_t old_root)
+{
+    struct mp3_library_record *record = &lib->record;
+    struct mp3_library_record *child = &lib->child;
+    struct mp3_library_level *level;
+    uint32_t depth = 0, old_child, len, name_len, i, j;
+    rt_err_t ret;
+
+    lib->level[0].rec = 0;
+    lib->level[0].old = old_root;
+    ret = mp3_library_read_dir(lib, &lib->level[0], 0);
+    while (ret == RT_EOK)
+    {
+        level = &lib->level[depth];
+        if (level->next == level->count)
+        {
+            /* all subdirectories walked,back to the parent */
+            if (depth == 0)
+                break;
+            depth--;
+            lib->path[lib->level[depth].len] = '\0';
+            continue;
+        }
+
+        /* each subdirectory appends its entries after the ones written so far */
+        i = level->next++;
+        if (mp3_library_record_read(lib->new_fd, level->first + i, child) != RT_EOK)
+            return RT_ERROR;
+        if (child->type != MP3_LIBRARY_DIR || depth + 1 >= MP3_LIBRARY_DEPTH_MAX)
+            continue;
+
+        old_child = MP3_LIBRARY_NONE;
+        if (level->unchanged)
+        {
+            old_child = level->old_first + i;
+        }
+        else if (level->old != MP3_LIBRARY_NONE)
+        {
+            /* directory was read again,find the subdirectory by name */
+            for (j = 0; j < level->old_count; j++)
+            {
+                if (mp3_library_record_read(lib->old_fd, level->old_first + j, record) == RT_EOK &&
+                    record->type == MP3_LIBRARY_DIR && strcmp(record->name, child->name) == 0)
+                {
+                    old_child = level->old_first + j;
+                    break;
+                }
+            }
+        }
+
+        len = level->len;
+        if (lib->path[len - 1] != '/')
+            lib->path[len++] = '/';
+        name_len = strlen(child->name);
+        if (len + name_len >= MP3_LIBRARY_PATH_MAX)
+        {
+            lib->path[level->len] = '\0';
+            continue;
+        }
+        memcpy(&lib->path[len], child->name, name_len + 1);
+        depth++;
+        lib->level[depth].rec = level->first + i;
+        lib->level[depth].old = old_child;
+        ret = mp3_library_read_dir(lib, &lib->level[depth], depth);
+    }
+
+    return ret;
+}
+
+/**
+ * @description: scanner thread
+ * @param {void *}parameter
+ * @return None
+ */
+static void mp3_library_entry(void *parameter)
+{
+    struct mp3_library *lib = (struct mp3_library *)parameter;
+    struct mp3_library_header header;
+    struct mp3_library_record record;
+    uint32_t old_root = MP3_LIBRARY_NONE;
+    rt_err_t ret = RT_ERROR;
+
+    lib->buf = rt_malloc(MP3_LIBRARY_BUFFER_SIZE);
+    lib->old_fd = open(MP3_LIBRARY_INDEX_PATH, O_RDONLY);
+    lib->new_fd = open(MP3_LIBRARY_TMP_PATH, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (lib->buf == RT_NULL || lib->new_fd < 0)
+    {
+        LOG_E("can not create %s", MP3_LIBRARY_TMP_PATH);
+        goto __exit;
+    }
+
+    /* the last index is only reused if it has the same root */
+    if (lib->old_fd >= 0 && mp3_library_header_read(lib->old_fd, &header) == RT_EOK &&
+        mp3_library_record_read(lib->old_fd, 0, &record) == RT_EOK && strcmp(record.name, lib->path) == 0)
+        old_root = 0;
+
+    memset(&header, 0, sizeof(header));
+    memset(&record, 0, sizeof(record));
+    record.type = MP3_LIBRARY_DIR;
+    strcpy(record.name, lib->path);
+    if (write(lib->new_fd, &header, sizeof(header)) != sizeof(header) ||
+        mp3_library_record_write(lib->new_fd, 0, &record) != RT_EOK)
+        goto __exit;
+    lib->progress.records = 1;
+
+    ret = mp3_library_walk(lib, old_root);
+    if (ret != RT_EOK)
+        goto __exit;
+
+    memcpy(header.magic, "MP3L", 4);
+    header.version = MP3_LIBRARY_VERSION;
+    header.records = lib->progress.records;
+    header.tracks = lib->progress.tracks;
+    if (lseek(lib->new_fd, 0, SEEK_SET) < 0 || write(lib->new_fd, &header, sizeof(header)) != sizeof(header))
+        ret = RT_ERROR;
+
+__exit:
+    if (lib->old_fd >= 0)
+        close(lib->old_fd);
+    if (lib->new_fd >= 0)
+        close(lib->new_fd);
+    if (ret == RT_EOK)
+    {
+        rt_mutex_take(&lib->lock, RT_WAITING_FOREVER);
+        unlink(MP3_LIBRARY_INDEX_PATH);
+        rename(MP3_LIBRARY_TMP_PATH, MP3_LIBRARY_INDEX_PATH);
+        rt_mutex_release(&lib->lock);
+        LOG_I("%d tracks,%d directories read,%d unchanged", lib->progress.tracks, lib->progress.dirs, lib->progress.dirs_skipped);
+    }
+    else
+    {
+        unlink(MP3_LIBRARY_TMP_PATH);
+        LOG_W("scan %s", lib->cancel ? "cancelled" : "failed");
+    }
+    rt_free(lib->buf);
+    lib->buf = RT_NULL;
+    lib->tid = RT_NULL;
+    lib->progress.state = ret == RT_EOK ? MP3_LIBRARY_DONE : MP3_LIBRARY_FAILED;
+}
+
+/**
+ * @description: start scanning a directory tree in background,
+ *               tags and duration of mp3 files go to the metadata cache
+ * @param {const char} *root kept as the name of the first record,shorter than MP3_LIBRARY_NAME_MAX
+ * @return the error code,0 on success,-RT_EINVAL if root is too long,-RT_EBUSY if a scan is running
+ */
+rt_err_t mp3_library_scan(const char *root)
+{
+    if (root == RT_NULL || root[0] == '\0' || strlen(root) >= MP3_LIBRARY_NAME_MAX)
+        return -RT_EINVAL;
+
+    rt_enter_critical();
+    if (library.progress.state == MP3_LIBRARY_SCANNING)
+    {
+        rt_exit_critical();
+        return -RT_EBUSY;
+    }
+    library.progress.state = MP3_LIBRARY_SCANNING;
+    rt_exit_critical();
+
+    memset(&library.progress, 0, sizeof(library.progress));
+    library.progress.state = MP3_LIBRARY_SCANNING;
+    library.cancel = 0;
+    library.yield = 0;
+    strcpy(library.path, root);
+
+    library.tid = rt_thread_create("mp3_scan",
+                                   mp3_library_entry,
+                                   &library,
+                                   MP3_LIBRARY_THREAD_STACK_SIZE,
+                                   MP3_LIBRARY_THREAD_PRIORITY, 10);
+    if (library.tid == RT_NULL)
+    {
+        library.progress.state = MP3_LIBRARY_FAILED;
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(library.tid);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: stop a running scan,the last index is kept
+ * @param None
+ * @return None
+ */
+void mp3_library_cancel(void)
+{
+    library.cancel = 1;
+}
+
+/**
+ * @description: get scan progress
+ * @param {struct mp3_library_progress} *progress
+ * @return None
+ */
+void mp3_library_progress_get(struct mp3_library_progress *progress)
+{
+    *progress = library.progress;
+}
+
+/**
+ * @description: get record and track count of the library index
+ * @param {uint32_t} *records
+ * @param {uint32_t} *tracks
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_library_info_get(uint32_t *records, uint32_t *tracks)
+{
+    struct mp3_library_header header;
+    rt_err_t ret = RT_ERROR;
+    int fd;
+
+    rt_mutex_take(&library.lock, RT_WAITING_FOREVER);
+    fd = open(MP3_LIBRARY_INDEX_PATH, O_RDONLY);
+    if (fd >= 0)
+    {
+        if (mp3_library_header_read(fd, &header) == RT_EOK)
+        {
+            *records = header.records;
+            *tracks = header.tracks;
+            ret = RT_EOK;
+        }
+        close(fd);
+    }
+    rt_mutex_release(&library.lock);
+
+    return ret;
+}
+
+/**
+ * @description: get path of a track in the library index
+ * @param {uint32_t} index record index,[0, records)
+ * @param {char} *path
+ * @param {uint32_t} size path size
+ * @return the error code,0 on success,RT_ERROR if the record is not a track
+ */
+rt_err_t mp3_library_track_path(uint32_t index, char *path, uint32_t size)
+{
+    struct mp3_library_header header;
+    struct mp3_library_record record;
+    uint32_t pos, len, i;
+    rt_err_t ret = RT_ERROR;
+    int fd;
+
+    if (path == RT_NULL || size == 0)
+        return RT_ERROR;
+
+    rt_mutex_take(&library.lock, RT_WAITING_FOREVER);
+    fd = open(MP3_LIBRARY_INDEX_PATH, O_RDONLY);
+    if (fd < 0)
+        goto __exit;
+    if (mp3_library_header_read(fd, &header) != RT_EOK || index >= header.records ||
+        mp3_library_record_read(fd, index, &record) != RT_EOK || record.type != MP3_LIBRARY_TRACK)
+        goto __exit;
+
+    /* build the path backwards,from the track up to the root */
+    pos = size - 1;
+    path[pos] = '\0';
+    for (i = 0; i <= MP3_LIBRARY_DEPTH_MAX + 1; i++)
+    {
+        len = strnlen(record.name, MP3_LIBRARY_NAME_MAX);
+        if (len > pos)
+            goto __exit;
+        pos -= len;
+        memcpy(path + pos, record.name, len);
+        if (index == 0)
+        {
+            memmove(path, path + pos, size - pos);
+            ret = RT_EOK;
+            break;
+        }
+
+        index = record.parent;
+        if (index >= header.records || mp3_library_record_read(fd, index, &record) != RT_EOK)
+            goto __exit;
+        len = strnlen(record.name, MP3_LIBRARY_NAME_MAX);
+        if (len == 0 || record.name[len - 1] != '/')
+        {
+            if (pos == 0)
+                goto __exit;
+            path[--pos] = '/';
+        }
+    }
+
+__exit:
+    if (fd >= 0)
+        close(fd);
+    rt_mutex_release(&library.lock);
+    return ret;
+}
+
+/**
+ * @description: init library scanner
+ * @param None
+ * @return the error code,0 on success
+ */
+int mp3_library_init(void)
+{
+    return rt_mutex_init(&library.lock, "mp3_lib", RT_IPC_FLAG_FIFO);
+}
+
+INIT_APP_EXPORT(mp3_library_init);
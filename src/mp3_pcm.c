@@ -0,0 +1,563 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_pcm.h"
+#include "mp3_stats.h"
+#include <string.h>
+
+#define LOG_TAG "mp3 pcm"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#define MP3_OUTPUT_THREAD_STACK_SIZE (1024)
+#define MP3_OUTPUT_THREAD_PRIORITY (14) /* above the decoder thread */
+
+#define PCM_EVENT_DATA (1 << 0)    /* decoder -> output: pcm queued or state changed */
+#define PCM_EVENT_SPACE (1 << 1)   /* output -> decoder: ring dropped to low watermark */
+#define PCM_EVENT_STOP (1 << 2)    /* decoder -> output: discard queued pcm */
+#define PCM_EVENT_STOPPED (1 << 3) /* output -> decoder: output is idle */
+#define PCM_EVENT_DRAINED (1 << 4) /* output -> decoder: ring is empty */
+
+#define PCM_FRAME_BYTES (4) /* 16 bit stereo */
+
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+/**
+ * @description: get replay structure of the sound device if it can lend blocks
+ * @param {rt_device_t} device
+ * @param {rt_uint32_t} frame_size
+ * @return replay structure,RT_NULL if blocks can not be borrowed
+ */
+static struct rt_audio_replay *mp3_pcm_replay_get(rt_device_t device, rt_uint32_t frame_size)
+{
+    struct rt_audio_device *audio = (struct rt_audio_device *)device;
+
+    /* only devices of the audio framework, with a block large enough for a frame */
+    if (device == RT_NULL || device->type != RT_Device_Class_Sound)
+        return RT_NULL;
+    if (audio->replay == RT_NULL || audio->replay->mp == RT_NULL)
+        return RT_NULL;
+    if (RT_AUDIO_REPLAY_MP_BLOCK_SIZE < frame_size || audio->replay->write_index != 0)
+        return RT_NULL;
+
+    return audio->replay;
+}
+#endif
+
+/**
+ * @description: get queued pcm bytes
+ * @param {struct mp3_pcm_output} *out
+ * @return queued bytes
+ */
+rt_uint32_t mp3_pcm_output_used(struct mp3_pcm_output *out)
+{
+    rt_uint32_t read_pos = out->read_pos;
+    rt_uint32_t write_pos = out->write_pos;
+
+    if (write_pos >= read_pos)
+        return write_pos - read_pos;
+    return out->size - read_pos + write_pos;
+}
+
+/**
+ * @description: get free pcm bytes,one byte is kept free to tell full from empty
+ * @param {struct mp3_pcm_output} *out
+ * @return free bytes
+ */
+static rt_uint32_t mp3_pcm_output_space(struct mp3_pcm_output *out)
+{
+    return out->size - 1 - mp3_pcm_output_used(out);
+}
+
+/**
+ * @description: write queued pcm to the sound device while running
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+static void mp3_pcm_output_run(struct mp3_pcm_output *out)
+{
+    rt_uint32_t used;
+    rt_uint32_t size;
+    rt_uint32_t first;
+    rt_uint32_t read_pos;
+
+    while (out->state == PCM_OUTPUT_STATE_RUNNING)
+    {
+        used = mp3_pcm_output_used(out);
+        if (used == 0)
+        {
+            if (out->draining)
+            {
+                rt_event_send(out->event, PCM_EVENT_DRAINED);
+            }
+            else
+            {
+                if (!out->prefill)
+                    MP3_STATS_ADD(underruns, 1);
+                out->prefill = 1; /* underrun, build up margin again */
+            }
+            break;
+        }
+        if (out->prefill && used < out->high_watermark && !out->draining)
+            break;
+        /* merge partial frames, a short period is only written at stream end */
+        if (used < out->period_size && !out->draining)
+            break;
+        out->prefill = 0;
+
+        size = used < out->period_size ? used : out->period_size;
+        read_pos = out->read_pos;
+        first = out->size - read_pos;
+        if (first > size)
+            first = size;
+        MP3_STATS_TIME(write, rt_device_write(out->device, 0, out->buffer + read_pos, first));
+        if (size > first)
+            MP3_STATS_TIME(write, rt_device_write(out->device, 0, out->buffer, size - first));
+
+        read_pos += size;
+        if (read_pos >= out->size)
+            read_pos -= out->size;
+        out->read_pos = read_pos;
+        out->samples += size / PCM_FRAME_BYTES;
+        if (out->first_tick == 0)
+            out->first_tick = rt_tick_get();
+
+        if (used - size <= out->low_watermark)
+            rt_event_send(out->event, PCM_EVENT_SPACE);
+    }
+}
+
+/**
+ * @description: pcm output thread
+ * @param {void *}parameter
+ * @return None
+ */
+static void mp3_pcm_output_entry(void *parameter)
+{
+    struct mp3_pcm_output *out = (struct mp3_pcm_output *)parameter;
+    rt_uint32_t recved;
+
+    while (1)
+    {
+        if (rt_event_recv(out->event, PCM_EVENT_DATA | PCM_EVENT_STOP,
+                          RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_FOREVER, &recved) != RT_EOK)
+            continue;
+
+        if (recved & PCM_EVENT_STOP)
+        {
+            /* drop everything, the decoder resets the ring after ack */
+            out->read_pos = out->write_pos;
+            rt_event_send(out->event, PCM_EVENT_STOPPED);
+            continue;
+        }
+        mp3_pcm_output_run(out);
+    }
+}
+
+/**
+ * @description: init pcm output stage and start the output thread
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} frame_size max bytes of one decoded frame
+ * @param {rt_uint32_t} frames ring size in frames
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_pcm_output_init(struct mp3_pcm_output *out, rt_uint32_t frame_size, rt_uint32_t frames)
+{
+    rt_uint32_t high = MP3_PCM_HIGH_WATERMARK;
+    rt_uint32_t low = MP3_PCM_LOW_WATERMARK;
+
+    if (frames < 2)
+        frames = 2;
+    /* decoder must always find a free frame below the high watermark */
+    if (high > frames - 1)
+        high = frames - 1;
+    if (low >= high)
+        low = high - 1;
+
+    memset(out, 0, sizeof(struct mp3_pcm_output));
+    out->frame_size = frame_size;
+    out->size = frame_size * frames;
+    out->high_watermark = frame_size * high;
+    out->low_watermark = frame_size * low;
+    out->period_size = MP3_OUTPUT_PERIOD_SIZE;
+    if (out->period_size > out->high_watermark)
+        out->period_size = out->high_watermark;
+    /* output waits for a full period, decoder must be woken up before that */
+    if (out->low_watermark < out->period_size)
+        out->low_watermark = out->period_size;
+
+    out->buffer = rt_malloc(out->size + frame_size);
+    if (out->buffer == RT_NULL)
+    {
+        LOG_E("can not malloc pcm ring for mp3 player.");
+        return -RT_ENOMEM;
+    }
+
+    out->event = rt_event_create("mp3_pcm", RT_IPC_FLAG_FIFO);
+    if (out->event == RT_NULL)
+        goto __exit;
+
+    out->tid = rt_thread_create("mp3_out",
+                                mp3_pcm_output_entry,
+                                out,
+                                MP3_OUTPUT_THREAD_STACK_SIZE,
+                                MP3_OUTPUT_THREAD_PRIORITY, 10);
+    if (out->tid == RT_NULL)
+        goto __exit;
+    rt_thread_startup(out->tid);
+
+    return RT_EOK;
+
+__exit:
+    if (out->event)
+    {
+        rt_event_delete(out->event);
+        out->event = RT_NULL;
+    }
+    rt_free(out->buffer);
+    out->buffer = RT_NULL;
+    return -RT_ERROR;
+}
+
+/**
+ * @description: start feeding the sound device,samplerate set by the last start is kept for the same device
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_device_t} device opened sound device
+ * @return None
+ */
+void mp3_pcm_output_start(struct mp3_pcm_output *out, rt_device_t device)
+{
+    if (out->device != device)
+        out->samplerate = 0; /* configured by the first frame */
+    out->device = device;
+    out->read_pos = 0;
+    out->write_pos = 0;
+    out->prefill = 1;
+    out->draining = 0;
+    out->throttled = 0;
+    out->block = RT_NULL;
+    out->zero_copy = 0;
+    out->samples = 0;
+    out->first_tick = 0;
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    out->pushes = 0;
+    if (mp3_pcm_replay_get(device, out->frame_size) != RT_NULL)
+        out->zero_copy = 1;
+    else
+        LOG_I("%s can not lend replay blocks, use pcm ring", MP3_SOUND_DEVICE_NAME);
+#endif
+    out->state = PCM_OUTPUT_STATE_RUNNING;
+}
+
+/**
+ * @description: stop output and discard all queued pcm
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_stop(struct mp3_pcm_output *out)
+{
+    if (out->state == PCM_OUTPUT_STATE_STOPPED)
+        return;
+
+    out->state = PCM_OUTPUT_STATE_STOPPED;
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    if (out->block)
+    {
+        /* give back the block that was never queued */
+        rt_mp_free(out->block);
+        out->block = RT_NULL;
+    }
+#endif
+    rt_event_recv(out->event, PCM_EVENT_STOPPED, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_NO, RT_NULL);
+    rt_event_send(out->event, PCM_EVENT_STOP);
+    rt_event_recv(out->event, PCM_EVENT_STOPPED, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, RT_NULL);
+
+    out->read_pos = 0;
+    out->write_pos = 0;
+}
+
+/**
+ * @description: stop output and forget the sound device,called before it is closed
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_release(struct mp3_pcm_output *out)
+{
+    mp3_pcm_output_stop(out);
+    out->device = RT_NULL;
+    out->samplerate = 0;
+}
+
+/**
+ * @description: discard all queued pcm and build up margin again,the state is kept
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_flush(struct mp3_pcm_output *out)
+{
+    rt_uint8_t state = out->state;
+
+    if (state == PCM_OUTPUT_STATE_STOPPED)
+        return;
+
+    mp3_pcm_output_stop(out);
+    out->prefill = 1;
+    out->draining = 0;
+    out->throttled = 0;
+    out->state = state;
+    rt_event_send(out->event, PCM_EVENT_DATA);
+}
+
+/**
+ * @description: pause or resume output
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_bool_t} pause
+ * @return None
+ */
+void mp3_pcm_output_pause(struct mp3_pcm_output *out, rt_bool_t pause)
+{
+    if (out->state == PCM_OUTPUT_STATE_STOPPED)
+        return;
+
+    out->state = pause ? PCM_OUTPUT_STATE_PAUSED : PCM_OUTPUT_STATE_RUNNING;
+    rt_event_send(out->event, PCM_EVENT_DATA);
+}
+
+/**
+ * @description: wait until all queued pcm has been written to the device
+ * @param {struct mp3_pcm_output} *out
+ * @return None
+ */
+void mp3_pcm_output_drain(struct mp3_pcm_output *out)
+{
+    if (out->state != PCM_OUTPUT_STATE_RUNNING)
+        return;
+
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    if (out->zero_copy)
+    {
+        struct rt_audio_replay *replay = ((struct rt_audio_device *)out->device)->replay;
+
+        while (rt_data_queue_len(&replay->queue) != 0)
+            rt_thread_mdelay(5);
+        return;
+    }
+#endif
+
+    out->draining = 1;
+    rt_event_send(out->event, PCM_EVENT_DATA);
+    while (mp3_pcm_output_used(out) != 0)
+    {
+        rt_event_recv(out->event, PCM_EVENT_DRAINED, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, RT_NULL);
+    }
+    out->draining = 0;
+}
+
+/**
+ * @description: get space for one decoded frame
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_int32_t} timeout ticks to wait for the ring to drain to low watermark
+ * @return pointer to at least frame_size writable bytes,RT_NULL if decoder should wait
+ */
+rt_uint8_t *mp3_pcm_output_reserve(struct mp3_pcm_output *out, rt_int32_t timeout)
+{
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    if (out->zero_copy)
+    {
+        /* the block pool is the ring, waits while all blocks are queued */
+        if (out->block == RT_NULL)
+            out->block = rt_mp_alloc(((struct rt_audio_device *)out->device)->replay->mp, timeout);
+        return out->block;
+    }
+#endif
+
+    if (mp3_pcm_output_used(out) >= out->high_watermark || mp3_pcm_output_space(out) < out->frame_size)
+        out->throttled = 1;
+
+    if (out->throttled)
+    {
+        /* decode ran far enough ahead, sleep until output catches up */
+        if (mp3_pcm_output_used(out) > out->low_watermark)
+        {
+            rt_event_recv(out->event, PCM_EVENT_SPACE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, timeout, RT_NULL);
+            if (mp3_pcm_output_used(out) > out->low_watermark)
+                return RT_NULL;
+        }
+        out->throttled = 0;
+    }
+
+    return out->buffer + out->write_pos;
+}
+
+/**
+ * @description: queue bytes written to the reserved space
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} size bytes written, no more than frame_size
+ * @return None
+ */
+void mp3_pcm_output_commit(struct mp3_pcm_output *out, rt_uint32_t size)
+{
+    rt_uint32_t write_pos;
+
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    if (out->zero_copy)
+    {
+        struct rt_audio_replay *replay = ((struct rt_audio_device *)out->device)->replay;
+        rt_base_t level;
+
+        /* counted before the push,mp3_pcm_output_played takes the last pushed sizes as the queue */
+        level = rt_hw_interrupt_disable();
+        out->pushed[out->pushes % RT_AUDIO_REPLAY_MP_BLOCK_COUNT] = size;
+        out->pushes++;
+        out->samples += size / PCM_FRAME_BYTES;
+        rt_hw_interrupt_enable(level);
+
+        /* hand the block over, the framework frees it once played */
+        rt_data_queue_push(&replay->queue, out->block, size, RT_WAITING_FOREVER);
+        out->block = RT_NULL;
+        if (out->first_tick == 0)
+            out->first_tick = rt_tick_get();
+        if (replay->activated != RT_TRUE)
+            rt_device_write(out->device, 0, replay->mp, 0); /* empty write starts replay */
+        return;
+    }
+#endif
+
+    write_pos = out->write_pos + size;
+
+    if (write_pos >= out->size)
+    {
+        /* fold the part written into the tail back to the ring head */
+        write_pos -= out->size;
+        if (write_pos)
+            memcpy(out->buffer, out->buffer + out->size, write_pos);
+    }
+    out->write_pos = write_pos;
+
+    write_pos = mp3_pcm_output_used(out);
+    if ((!out->prefill && write_pos >= out->period_size) || write_pos >= out->high_watermark)
+        rt_event_send(out->event, PCM_EVENT_DATA);
+}
+
+/**
+ * @description: set samplerate of the sound device,queued pcm of the old samplerate is played first
+ * @param {struct mp3_pcm_output} *out
+ * @param {rt_uint32_t} samplerate
+ * @return None
+ */
+void mp3_pcm_output_configure(struct mp3_pcm_output *out, rt_uint32_t samplerate)
+{
+    struct rt_audio_caps caps;
+
+    if (out->samplerate == samplerate || out->device == RT_NULL)
+        return;
+
+    mp3_pcm_output_drain(out);
+
+    /* set sampletate,channels, samplebits */
+    caps.main_type = AUDIO_TYPE_OUTPUT;
+    caps.sub_type = AUDIO_DSP_PARAM;
+    caps.udata.config.samplerate = samplerate;
+    caps.udata.config.channels = 2;
+    caps.udata.config.samplebits = 16;
+    rt_device_control(out->device, AUDIO_CTL_CONFIGURE, &caps);
+    out->samplerate = samplerate;
+}
+
+/**
+ * @description: get samples handed to the sound device since start
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_samples(struct mp3_pcm_output *out)
+{
+    return out->samples;
+}
+
+/**
+ * @description: get samples queued to the output stage since start,played or not
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_committed(struct mp3_pcm_output *out)
+{
+    rt_uint32_t samples, used;
+
+    /* the output thread moves bytes from the ring to the device count in between */
+    do
+    {
+        samples = out->samples;
+        used = mp3_pcm_output_used(out);
+    } while (samples != out->samples);
+
+    return samples + used / PCM_FRAME_BYTES;
+}
+
+/**
+ * @description: get samples the sound device has played since start,
+ *               pcm in the dma buffer of the audio framework is estimated
+ * @param {struct mp3_pcm_output} *out
+ * @return samples per channel
+ */
+rt_uint32_t mp3_pcm_output_played(struct mp3_pcm_output *out)
+{
+    struct rt_audio_replay *replay;
+    rt_device_t device = out->device;
+    rt_uint32_t samples, queued, dma, len;
+    rt_base_t level;
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    rt_uint32_t i;
+#endif
+
+    samples = out->samples;
+    if (device == RT_NULL || device->type != RT_Device_Class_Sound)
+        return samples;
+    replay = ((struct rt_audio_device *)device)->replay;
+    if (replay == RT_NULL)
+        return samples;
+
+    level = rt_hw_interrupt_disable();
+    samples = out->samples;
+    len = rt_data_queue_len(&replay->queue);
+#ifdef MP3_PLAYER_USING_ZERO_COPY
+    if (out->zero_copy)
+    {
+        /* blocks are queued as pushed,the newest len of them are still in the queue */
+        queued = 0;
+        for (i = 0; i < len && i < out->pushes && i < RT_AUDIO_REPLAY_MP_BLOCK_COUNT; i++)
+            queued += out->pushed[(out->pushes - 1 - i) % RT_AUDIO_REPLAY_MP_BLOCK_COUNT];
+    }
+    else
+#endif
+    {
+        /* the framework only queues full blocks,the partial one is at write_index */
+#ifdef RT_AUDIO_REPLAY_MP_BLOCK_SIZE
+        queued = len * RT_AUDIO_REPLAY_MP_BLOCK_SIZE + replay->write_index;
+#else
+        queued = len * out->period_size + replay->write_index;
+#endif
+    }
+    /* read_index bytes of the first block are copied to the dma buffer already */
+    queued = queued > replay->read_index ? queued - replay->read_index : 0;
+    /*
+     * the dma buffer is a ring of block_count blocks,each block is refilled
+     * when it completes and plays after the other ones,so between
+     * block_count - 1 and block_count blocks of it are not played yet.
+     */
+    dma = 0;
+    if (replay->activated == RT_TRUE && replay->buf_info.total_size >= replay->buf_info.block_size)
+        dma = replay->buf_info.total_size - replay->buf_info.block_size / 2;
+    rt_hw_interrupt_enable(level);
+
+    queued /= PCM_FRAME_BYTES;
+    if (samples <= queued)
+        return 0;
+    samples -= queued;
+    /* no more than what left the queue can be in the dma buffer */
+    dma /= PCM_FRAME_BYTES;
+    return samples > dma ? samples - dma : 0;
+}
@@ -14,6 +14,9 @@
 #include <ulog.h>
 
 #include "mp3_tag.h"
+#include "mp3_frame.h"
+#include "mp3_cache.h"
+#include "mp3common.h" /* helix internal decoder state */
 
 #define VOLUME_MIN (0)
 #define VOLUME_MAX (100)
@@ -22,7 +25,37 @@
 #define MP3_THREAD_STATCK_SIZE (1024 * 2)
 #define MP3_THREAD_PRIORITY (15)
 
+#define MP3_PCM_WAIT_MS (20) /* max time the decoder sleeps on a full pcm ring */
+
+#define MP3_BG_THREAD_STACK_SIZE (1024 * 2)
+#define MP3_BG_THREAD_PRIORITY (25) /* well below the player, only uses idle time */
+#define MP3_BG_BUFFER_SIZE (1024 * 4)
+
+#define MP3_INPUT_WAIT_MS (20) /* max time the decoder waits for the read-ahead thread */
+
+#define MP3_DECODER_DELAY (529) /* samples of delay added by the synthesis filterbank */
+
+/* seconds the sound device stays open after playback stops */
+#ifndef MP3_PLAYER_IDLE_TIMEOUT
+#define MP3_PLAYER_IDLE_TIMEOUT (5)
+#endif
+
+#ifdef MP3_PLAYER_USING_READAHEAD
+#define MP3_INPUT_RING_SIZE (MP3_READAHEAD_BLOCK_SIZE * MP3_READAHEAD_BLOCKS)
+#define MP3_INPUT_READ_SIZE MP3_READAHEAD_BLOCK_SIZE
+#else
+#define MP3_INPUT_RING_SIZE MP3_INPUT_BUFFER_SIZE
+#define MP3_INPUT_READ_SIZE MP3_INPUT_BLOCK_SIZE
+#endif
+
 static struct mp3_player player = {0};
+static struct mp3_pcm_output pcm_output;
+static struct mp3_seek_index seek_index;
+static struct mp3_input input;
+static struct mp3_readahead readahead;
+#ifdef MP3_PLAYER_USING_CACHE
+static struct mp3_cache cache;
+#endif
 
 #if (LOG_LVL >= DBG_LOG)
 
@@ -97,6 +130,7 @@ int mp3_player_play(char *uri)
     {
         mp3_player_stop();
     }
+    mp3_player_queue_next(RT_NULL);
     if (player.uri)
     {
         rt_free(player.uri);
@@ -109,6 +143,52 @@ int mp3_player_play(char *uri)
     return result;
 }
 
+/**
+ * @description: queue the music played after the current one
+ * @param {char} *uri RT_NULL to clear the queue
+ * @return the error code,0 on success
+ */
+int mp3_player_queue_next(char *uri)
+{
+    char *next = RT_NULL;
+    char *last;
+
+    if (uri)
+    {
+        next = rt_strdup(uri);
+        if (next == RT_NULL)
+            return -RT_ENOMEM;
+    }
+
+    /* the player thread takes it at the end of current track */
+    rt_enter_critical();
+    last = player.next_uri;
+    player.next_uri = next;
+    player.next_seq++;
+    rt_exit_critical();
+    if (last)
+        rt_free(last);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: take the queued music
+ * @param {struct mp3_player} *player
+ * @return uri,RT_NULL if nothing is queued
+ */
+static char *mp3_player_queue_pop(struct mp3_player *player)
+{
+    char *uri;
+
+    rt_enter_critical();
+    uri = player->next_uri;
+    player->next_uri = RT_NULL;
+    rt_exit_critical();
+
+    return uri;
+}
+
 /**
  * @description: stop playing
  * @param None
@@ -119,6 +199,7 @@ int mp3_player_stop(void)
     rt_err_t result = RT_EOK;
 
     rt_completion_init(&player.ack);
+    mp3_player_queue_next(RT_NULL);
 
     play_lock();
     if (player.state != PLAYER_STATE_STOPED)
@@ -172,28 +253,61 @@ int mp3_player_resume(void)
 }
 
 /**
- * @description: set volume
+ * @description: apply volume to the sound device
+ * @param {struct mp3_player} *player
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_volume_apply(struct mp3_player *player)
+{
+    struct rt_audio_caps caps;
+
+    player->audio_device = rt_device_find(MP3_SOUND_DEVICE_NAME);
+    if (player->audio_device == RT_NULL)
+        return RT_ERROR;
+
+    caps.main_type = AUDIO_TYPE_MIXER;
+    caps.sub_type = AUDIO_MIXER_VOLUME;
+    caps.udata.value = player->volume;
+
+    LOG_D("set volume = %d", player->volume);
+    return rt_device_control(player->audio_device, AUDIO_CTL_CONFIGURE, &caps);
+}
+
+/**
+ * @description: set volume,applied by the player thread,a burst of calls is applied once
  * @param {int} volume
  * @return the error code,0 on success
  */
 int mp3_player_volume_set(int volume)
 {
-    struct rt_audio_caps caps;
+    rt_uint8_t queued;
+
     if (volume < VOLUME_MIN)
         volume = VOLUME_MIN;
     else if (volume > VOLUME_MAX)
         volume = VOLUME_MAX;
-    player.audio_device = rt_device_find(MP3_SOUND_DEVICE_NAME);
-    if (player.audio_device == RT_NULL)
-        return RT_ERROR;
 
+    if (player.mq == RT_NULL)
+    {
+        /* player thread is not running */
+        player.volume = volume;
+        return mp3_player_volume_apply(&player);
+    }
+
+    rt_enter_critical();
     player.volume = volume;
-    caps.main_type = AUDIO_TYPE_MIXER;
-    caps.sub_type = AUDIO_MIXER_VOLUME;
-    caps.udata.value = volume;
+    queued = player.volume_queued;
+    player.volume_queued = 1;
+    rt_exit_critical();
+    if (queued)
+        return RT_EOK; /* the queued message takes the latest volume */
 
-    LOG_D("set volume = %d", volume);
-    return rt_device_control(player.audio_device, AUDIO_CTL_CONFIGURE, &caps);
+    if (play_msg_send(&player, MSG_VOLUME, RT_NULL) != RT_EOK)
+    {
+        player.volume_queued = 0;
+        return RT_ERROR;
+    }
+    return RT_EOK;
 }
 
 /**
@@ -227,261 +341,1381 @@ char *mp3_player_uri_get(void)
 }
 
 /**
- * @description: get mp3 current time in seconds
- * @param {FILE} *fp
- * @param {mp3_info_t} *mp3_info
- * @return current seconds,-1 on error
+ * @description: get pcm samples written to the sound device
+ * @param None
+ * @return samples per channel since play start
  */
-uint32_t mp3_get_cur_seconds(void)
+uint32_t mp3_player_samples_get(void)
 {
-    uint32_t fpos = 0;
-    uint32_t fptr;
-    uint32_t curent_seconds;
-
-    if (player.fp == RT_NULL)
-    {
-        return 0;
-    }
-    fptr = ftell(player.fp);
-    if (fptr > player.mp3_info.data_start)
-        fpos = fptr - player.mp3_info.data_start;
-
-    curent_seconds = fpos * player.mp3_info.total_seconds / (player.mp3_info.file_size - player.mp3_info.data_start);
-    player.mp3_info.curent_seconds = curent_seconds;
-    return curent_seconds;
+    return player.pcm ? mp3_pcm_output_samples(player.pcm) : 0;
 }
 
 /**
- * @description: seek to destination seconds
- * @param {uint32_t} seconds
- * @return the error code,0 on success
+ * @description: set track position of the pcm queued next,called by the player thread
+ * @param {struct mp3_player} *player
+ * @param {uint32_t} ms
+ * @return None
  */
-rt_err_t mp3_seek(uint32_t seconds)
+static void mp3_player_position_set(struct mp3_player *player, uint32_t ms)
 {
-    long fpos;
-    if (seconds > player.mp3_info.total_seconds)
-        return RT_ERROR;
-    /* calculate position by seconds*/
-    fpos = seconds * (player.mp3_info.bitrate / 8) + player.mp3_info.data_start;
-    if (fpos < player.mp3_info.data_start)
-        return RT_ERROR;
-    return fseek(player.fp, fpos + player.mp3_info.data_start, SEEK_SET);
+    uint32_t mark = mp3_pcm_output_committed(player->pcm);
+    rt_base_t level;
+
+    /* both fields change together,readers take them under the same lock */
+    level = rt_hw_interrupt_disable();
+    player->pos_base_ms = ms;
+    player->pos_mark = mark;
+    rt_hw_interrupt_enable(level);
 }
 
 /**
- * @description: show mp3 info
+ * @description: get playback position of the current track
  * @param None
- * @return None
+ * @return position in milliseconds,0 if stopped
  */
-void mp3_info_show(void)
+uint32_t mp3_player_position_ms(void)
 {
-    mp3_info_print(player.mp3_info);
+    struct mp3_pcm_output *pcm = player.pcm;
+    uint32_t base_ms, mark, samplerate;
+    int32_t played;
+    rt_base_t level;
+
+    if (pcm == RT_NULL || player.state == PLAYER_STATE_STOPED)
+        return 0;
+
+    level = rt_hw_interrupt_disable();
+    base_ms = player.pos_base_ms;
+    mark = player.pos_mark;
+    rt_hw_interrupt_enable(level);
+
+    /* pcm queued before the mark,e.g. the end of the last track,is still playing */
+    played = (int32_t)(mp3_pcm_output_played(pcm) - mark);
+    samplerate = pcm->samplerate;
+    if (played <= 0 || samplerate == 0)
+        return base_ms;
+
+    return base_ms + (uint64_t)played * 1000 / samplerate;
 }
 
 /**
- * @description: show mp3 current seconds
+ * @description: get mp3 current time in seconds
  * @param None
- * @return None
+ * @return current seconds
  */
-void mp3_disp_time(void)
+uint32_t mp3_get_cur_seconds(void)
 {
-    uint32_t cur_seconds;
-    cur_seconds = mp3_get_cur_seconds();
-    rt_kprintf("%02d:%02d / %02d:%02d\r\n", cur_seconds / 60, cur_seconds % 60, player.mp3_info.total_seconds / 60, player.mp3_info.total_seconds % 60);
+    uint32_t curent_seconds;
+
+    curent_seconds = mp3_player_position_ms() / 1000;
+    player.mp3_info.curent_seconds = curent_seconds;
+    return curent_seconds;
 }
 
 /**
- * @description: open mp3 player
+ * @description: get file offset of a position by vbr toc
+ * @param {mp3_info_t} *mp3_info
+ * @param {uint32_t} ms
+ * @return file offset
+ */
+static uint32_t mp3_toc_offset(mp3_info_t *mp3_info, uint32_t ms)
+{
+    uint32_t permille, percent, fa, fb, fx;
+
+    /* position in 1/1000 percent */
+    permille = (uint64_t)ms * MP3_TOC_SIZE / mp3_info->total_seconds;
+    percent = permille / 1000;
+    if (percent >= MP3_TOC_SIZE)
+        return mp3_info->data_start + mp3_info->vbr_bytes;
+
+    fa = mp3_info->toc[percent];
+    fb = (percent < MP3_TOC_SIZE - 1) ? mp3_info->toc[percent + 1] : 256;
+    if (fb < fa)
+        fb = fa;
+    fx = fa * 1000 + (fb - fa) * (permille % 1000);
+
+    return mp3_info->data_start + (uint64_t)fx * mp3_info->vbr_bytes / (256 * 1000);
+}
+
+/**
+ * @description: set up a seek to destination milliseconds,called by the player thread,
+ *               sample accurate once the seek index covers it
  * @param {struct mp3_player} *player
+ * @param {uint32_t} ms
  * @return the error code,0 on success
  */
-static rt_err_t mp3_player_open(struct mp3_player *player)
+static rt_err_t mp3_player_seek_prepare(struct mp3_player *player, uint32_t ms)
 {
-    rt_err_t result = RT_EOK;
-    struct rt_audio_caps caps;
+    struct mp3_seek_index *index = player->seek_index;
+    uint32_t frame, start, entry_frame, offset;
+    uint64_t sample;
 
-    /* find device */
-    player->audio_device = rt_device_find(MP3_SOUND_DEVICE_NAME);
-    if (player->audio_device == RT_NULL)
-    {
-        LOG_E("audio_device %s not found", MP3_SOUND_DEVICE_NAME);
-        result = -RT_ERROR;
-        goto __exit;
-    }
+    if (player->state == PLAYER_STATE_STOPED || ms / 1000 > player->mp3_info.total_seconds)
+        return RT_ERROR;
 
-    /* open file */
-    player->fp = fopen(player->uri, "rb"); /* readonly */
-    if (player->fp == RT_NULL)
+    if (index->samples && index->samplerate)
     {
-        LOG_E("open file %s failed", player->uri);
-        result = -RT_ERROR;
-        goto __exit;
+        /* decoder output sample of the position */
+        sample = (uint64_t)ms * index->samplerate / 1000;
+#ifdef MP3_PLAYER_USING_GAPLESS
+        if (player->mp3_info.gapless)
+            sample += player->mp3_info.enc_delay + MP3_DECODER_DELAY;
+#endif
+        frame = sample / index->samples;
+        /* the preroll frames before the target must be walked from an entry too */
+        start = frame > MP3_PREROLL_FRAMES_MAX ? frame - MP3_PREROLL_FRAMES_MAX : 0;
+        if (frame < index->frames && mp3_seek_index_lookup(index, start, &entry_frame, &offset) == RT_EOK)
+        {
+            /* sample accurate, the player thread walks the rest of the way */
+            player->seek_offset = offset;
+            player->seek_skip_frames = frame - entry_frame;
+            player->seek_frame = frame;
+            player->seek_skip_samples = sample - (uint64_t)frame * index->samples;
+            player->seek_ms = ms;
+            player->seek_pending = 1;
+            return RT_EOK;
+        }
     }
 
-    /* open sound device */
-    result = rt_device_open(player->audio_device, RT_DEVICE_OFLAG_WRONLY);
-    if (result != RT_EOK)
+    if (player->mp3_info.toc_valid && player->mp3_info.total_seconds)
     {
-        LOG_E("open %s audio_device failed", MP3_SOUND_DEVICE_NAME);
-        goto __exit;
+        /* index not built that far, interpolate the vbr toc */
+        player->seek_offset = mp3_toc_offset(&player->mp3_info, ms);
     }
-
-    /* init decoder */
-    player->mp3_decoder = MP3InitDecoder();
-    if (player->mp3_decoder == 0)
+    else
     {
-        LOG_E("initialize helix mp3 decoder fail!");
-        result = RT_ERROR;
-        goto __exit;
+        /* calculate position by bitrate */
+        player->seek_offset = (uint64_t)ms * (player->mp3_info.bitrate / 8) / 1000 + player->mp3_info.data_start;
     }
-
-    /* set sampletate,channels, samplebits */
-    caps.main_type = AUDIO_TYPE_OUTPUT;
-    caps.sub_type = AUDIO_DSP_PARAM;
-    caps.udata.config.samplerate = 44100;
-    caps.udata.config.channels = 2;
-    caps.udata.config.samplebits = 16;
-    rt_device_control(player->audio_device, AUDIO_CTL_CONFIGURE, &caps);
+    player->seek_skip_frames = 0;
+    player->seek_frame = UINT32_MAX;
+    player->seek_skip_samples = 0;
+    player->seek_ms = ms;
+    player->seek_pending = 1;
 
     return RT_EOK;
+}
 
-__exit:
-    if (player->fp)
-    {
-        fclose(player->fp);
-        player->fp = RT_NULL;
-    }
+/**
+ * @description: seek to destination milliseconds,applied by the player thread,
+ *               a burst of calls seeks once to the latest position
+ * @param {uint32_t} ms
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek_ms(uint32_t ms)
+{
+    rt_uint8_t queued;
+
+    if (player.state == PLAYER_STATE_STOPED || ms / 1000 > player.mp3_info.total_seconds)
+        return RT_ERROR;
+
+    rt_enter_critical();
+    player.seek_request_ms = ms;
+    queued = player.seek_queued;
+    player.seek_queued = 1;
+    rt_exit_critical();
+    if (queued)
+        return RT_EOK; /* the queued message takes the latest position */
 
-    if (player->audio_device)
+    if (play_msg_send(&player, MSG_SEEK, RT_NULL) != RT_EOK)
     {
-        rt_device_close(player->audio_device);
-        player->audio_device = RT_NULL;
+        player.seek_queued = 0;
+        return RT_ERROR;
     }
+    return RT_EOK;
+}
+
+/**
+ * @description: seek to destination seconds
+ * @param {uint32_t} seconds
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek(uint32_t seconds)
+{
+    if (seconds > player.mp3_info.total_seconds)
+        return RT_ERROR;
+
+    return mp3_seek_ms(seconds * 1000);
+}
+
+/**
+ * @description: get an embedded picture of the current track
+ * @param {int} index picture index
+ * @param {mp3_picture_t} *picture
+ * @return the error code,0 on success
+ */
+int mp3_player_picture_get(int index, mp3_picture_t *picture)
+{
+    int ret = -RT_ERROR;
 
-    if (player->mp3_decoder)
+    /* mp3 info may be replaced by the player thread */
+    rt_enter_critical();
+    if (index >= 0 && index < player.mp3_info.mp3_basic_info.picture_count)
     {
-        MP3FreeDecoder(player->mp3_decoder);
+        *picture = player.mp3_info.mp3_basic_info.picture[index];
+        ret = RT_EOK;
     }
+    rt_exit_critical();
 
-    return result;
+    return ret;
 }
 
 /**
- * @description:close mp3 player 
- * @param {struct mp3_player} *player
+ * @description: get resync statistics
+ * @param {uint32_t} *events times the frame sync was lost
+ * @param {uint32_t} *bytes bytes skipped to find it again
  * @return None
  */
-static void mp3_player_close(struct mp3_player *player)
+void mp3_player_resync_get(uint32_t *events, uint32_t *bytes)
+{
+    *events = player.resyncs;
+    *bytes = player.resync_bytes;
+}
+
+/**
+ * @description: decode a file as fast as possible without playing it,on the player thread
+ * @param {const char} *uri
+ * @param {struct mp3_bench} *bench result
+ * @return the error code,0 on success,-RT_EBUSY if the player is not stopped
+ */
+int mp3_player_bench(const char *uri, struct mp3_bench *bench)
 {
-    if (player->fp)
+    rt_err_t result;
+
+    memset(bench, 0, sizeof(struct mp3_bench));
+    bench->uri = uri;
+
+    play_lock();
+    if (player.state != PLAYER_STATE_STOPED)
     {
-        fclose(player->fp);
-        player->fp = RT_NULL;
+        play_unlock();
+        return -RT_EBUSY;
     }
-    if (player->audio_device)
+    rt_completion_init(&player.ack);
+    result = play_msg_send(&player, MSG_BENCH, bench);
+    if (result == RT_EOK)
     {
-        rt_device_close(player->audio_device);
-        player->audio_device = RT_NULL;
+        rt_completion_wait(&player.ack, RT_WAITING_FOREVER);
+        result = bench->result;
     }
-    if (player->mp3_decoder)
+    play_unlock();
+
+    return result;
+}
+
+/**
+ * @description: get read-ahead statistics
+ * @param {uint32_t} *level percent of the input ring filled
+ * @param {uint32_t} *stalls times the decoder found the input empty
+ * @return None
+ */
+void mp3_player_readahead_get(uint32_t *level, uint32_t *stalls)
+{
+    if (player.readahead == RT_NULL)
     {
-        MP3FreeDecoder(player->mp3_decoder);
+        *level = 0;
+        *stalls = 0;
+        return;
     }
-    LOG_D("close mp3 player");
+    *level = mp3_readahead_level(player.readahead);
+    *stalls = player.readahead->stalls;
 }
 
 /**
- * @description: player event handler
+ * @description: set up encoder delay/padding trimming for decoding from a frame
  * @param {struct mp3_player} *player
- * @param {int} timeout
- * @return {int} mp3 event
+ * @param {uint32_t} frame first audio frame decoded,UINT32_MAX if not known
+ * @return None
  */
-static int mp3_player_event_handler(struct mp3_player *player, int timeout)
+static void mp3_player_trim_init(struct mp3_player *player, uint32_t frame)
 {
-    int event;
-    rt_err_t result;
-    struct play_msg msg;
-#if (LOG_LVL >= DBG_LOG)
-    rt_uint8_t last_state;
+#ifdef MP3_PLAYER_USING_GAPLESS
+    mp3_info_t *info = &player->mp3_info;
+    uint64_t start, first, last;
+    uint32_t samples;
 #endif
 
-    result = rt_mq_recv(player->mq, &msg, sizeof(struct play_msg), timeout);
-    #if RT_VER_NUM > 0x50000
-    if (!result)
-    #else
-    if (RT_EOK != result)
-    #endif
+    player->trim_skip = 0;
+    player->trim_remain = UINT32_MAX;
+
+#ifdef MP3_PLAYER_USING_GAPLESS
+    if (!info->gapless || info->total_frames == 0 || frame == UINT32_MAX)
+        return;
+
+    /* valid decoder output is [first, last),shifted by the decoder delay */
+    samples = info->total_samples / info->total_frames; /* per frame */
+    start = (uint64_t)frame * samples;
+    first = info->enc_delay + MP3_DECODER_DELAY;
+    last = (uint64_t)info->total_samples + MP3_DECODER_DELAY;
+    if (last < first + info->enc_padding)
+        return;
+    last -= info->enc_padding;
+
+    if (first > start)
     {
-        event = PLAYER_EVENT_NONE;
-        return event;
+        player->trim_skip = first - start;
+        start = first;
     }
-#if (LOG_LVL >= DBG_LOG)
-    last_state = player->state;
+    player->trim_remain = (last > start) ? last - start : 0;
 #endif
-    switch (msg.type)
-    {
-    case MSG_START:
-        event = PLAYER_EVENT_PLAY;
-        player->state = PLAYER_STATE_PLAYING;
-        break;
-    case MSG_STOP:
-        event = PLAYER_EVENT_STOP;
-        player->state = PLAYER_STATE_STOPED;
-        break;
-
-    case MSG_PAUSE:
-        event = PLAYER_EVENT_PAUSE;
-        player->state = PLAYER_STATE_PAUSED;
-        break;
+}
 
-    case MSG_RESUME:
-        event = PLAYER_EVENT_RESUME;
-        player->state = PLAYER_STATE_PLAYING;
-        break;
+/**
+ * @description: drop encoder delay and padding from the decoded frame
+ * @param {struct mp3_player} *player
+ * @param {uint32_t} samples samples per channel in out_buffer
+ * @return samples per channel kept,moved to the start of out_buffer
+ */
+static uint32_t mp3_player_trim(struct mp3_player *player, uint32_t samples)
+{
+    uint32_t skip;
 
-    default:
-        event = PLAYER_EVENT_NONE;
-        break;
+    if (player->trim_skip)
+    {
+        skip = (player->trim_skip < samples) ? player->trim_skip : samples;
+        player->trim_skip -= skip;
+        samples -= skip;
+        if (samples)
+            memmove(player->out_buffer, player->out_buffer + skip * 2, samples * 2 * sizeof(short));
+    }
+    if (player->trim_remain != UINT32_MAX)
+    {
+        if (samples > player->trim_remain)
+            samples = player->trim_remain;
+        player->trim_remain -= samples;
     }
-    rt_completion_done(&player->ack);
-#if (LOG_LVL >= DBG_LOG)
-    LOG_D("EVENT:%s, STATE:%s -> %s", event_str[event], state_str[last_state], state_str[player->state]);
-#endif
 
-    return event;
+    return samples;
 }
 
 /**
- * @description: mp3 player thread
- * @param {void *}parameter
+ * @description: reset decoder state between tracks without reallocating it
+ * @param {HMP3Decoder} decoder
  * @return None
  */
-static void mp3_player_entry(void *parameter)
+static void mp3_decoder_reset(HMP3Decoder decoder)
+{
+    MP3DecInfo *info = (MP3DecInfo *)decoder;
+
+    /*
+     * drop the bit reservoir of the last track, frames of the new track must
+     * not borrow main data from it. the overlap of the last granule only
+     * reaches the first granule, which is covered by the encoder delay.
+     */
+    info->mainDataBegin = 0;
+    info->mainDataBytes = 0;
+    info->freeBitrateFlag = 0;
+    info->freeBitrateSlots = 0;
+}
+
+/**
+ * @description: apply pending seek request in the player thread
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_seek_apply(struct mp3_player *player)
+{
+    uint32_t offset, skip;
+
+    player->seek_pending = 0;
+    /* the file and the ring belong to this thread until read-ahead restarts */
+    mp3_readahead_stop(player->readahead);
+
+    /* buffered data is dropped anyway, borrow the ring for the walk */
+    offset = mp3_frame_locate_preroll(player->fp, player->seek_offset, player->seek_skip_frames,
+                                      &player->preroll_frames, player->input->buffer, player->input->size);
+    mp3_file_seek(player->fp, offset, SEEK_SET);
+
+    mp3_readahead_start(player->readahead, player->fp, offset);
+    /* main data of the old position must not be borrowed by the preroll frames */
+    mp3_decoder_reset(player->mp3_decoder);
+    mp3_player_trim_init(player, player->seek_frame);
+    /* nothing decoded before the seek is played */
+    player->decode_oper.bytes_left = 0;
+    player->synced = 0;
+    mp3_pcm_output_flush(player->pcm);
+
+    /* samples of the target frame before the position */
+    skip = player->seek_skip_samples;
+    if (skip > player->trim_skip)
+    {
+        if (player->trim_remain != UINT32_MAX)
+            player->trim_remain = (player->trim_remain > skip - player->trim_skip) ? player->trim_remain - (skip - player->trim_skip) : 0;
+        player->trim_skip = skip;
+    }
+    mp3_player_position_set(player, player->seek_ms);
+}
+
+/**
+ * @description: get mp3 info of a file from the cache,parse and cache it on a miss
+ * @param {struct mp3_player} *player
+ * @param {const char} *uri
+ * @param {mp3_file_t} fp opened file of uri
+ * @param {mp3_info_t} *info
+ * @param {uint8_t} *buf scratch buffer
+ * @param {uint32_t} size scratch buffer size
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_info_load(struct mp3_player *player, const char *uri, mp3_file_t fp,
+                                     mp3_info_t *info, uint8_t *buf, uint32_t size)
+{
+#ifdef MP3_PLAYER_USING_CACHE
+    if (player->cache && mp3_cache_get(player->cache, uri, info) == RT_EOK)
+        return RT_EOK;
+#endif
+    if (mp3_info_parse(fp, info, buf, size) != RT_EOK)
+        return RT_ERROR;
+#ifdef MP3_PLAYER_USING_CACHE
+    if (player->cache)
+        mp3_cache_put(player->cache, uri, info);
+#endif
+    return RT_EOK;
+}
+
+/**
+ * @description: get mp3 info of a file from the metadata cache,the file is not opened
+ * @param {const char} *uri
+ * @param {mp3_info_t} *info
+ * @return the error code,0 on success
+ */
+int mp3_player_info_cached(const char *uri, mp3_info_t *info)
+{
+#ifdef MP3_PLAYER_USING_CACHE
+    if (player.cache && mp3_cache_get(player.cache, uri, info) == RT_EOK)
+        return RT_EOK;
+#endif
+    return -RT_ERROR;
+}
+
+/**
+ * @description: get metadata cache of the player
+ * @param None
+ * @return cache,RT_NULL if not used
+ */
+struct mp3_cache *mp3_player_cache_get(void)
+{
+    return player.cache;
+}
+
+/**
+ * @description: check if playback is running short of pcm
+ * @param None
+ * @return 1 if playing and the pcm ring is below its low watermark
+ */
+int mp3_player_underrun_get(void)
+{
+    if (player.state != PLAYER_STATE_PLAYING || player.pcm == RT_NULL)
+        return 0;
+
+    return player.pcm->prefill || mp3_pcm_output_used(player.pcm) < player.pcm->low_watermark;
+}
+
+#ifdef MP3_PLAYER_USING_EXACT_DURATION
+/**
+ * @description: take exact duration from the seek index,whose walk counted frames like mp3_info_exact
+ * @param {const char} *uri
+ * @return None
+ */
+static void mp3_player_bg_exact(const char *uri)
+{
+    struct mp3_seek_index *index = player.seek_index;
+
+    if (!index->ready || player.bg_info.total_frames != 0)
+        return; /* cancelled,or counted by the encoder */
+
+    mp3_info_exact_set(&player.bg_info, index->frames, index->total_samples, index->samplerate);
+    player.bg_info.vbr = index->vbr;
+#ifdef MP3_PLAYER_USING_CACHE
+    if (player.cache)
+        mp3_cache_put(player.cache, uri, &player.bg_info);
+#endif
+    player.duration_ready = 1; /* applied by the player thread */
+}
+#endif
+
+/**
+ * @description: background thread, parses metadata in fast start mode and builds the seek index of current file
+ * @param {void *}parameter private copy of uri
+ * @return None
+ */
+static void mp3_player_bg_entry(void *parameter)
+{
+    char *uri = (char *)parameter;
+    uint8_t *buf;
+    mp3_file_t fp;
+
+    buf = rt_malloc(MP3_BG_BUFFER_SIZE);
+    fp = mp3_file_open(uri);
+    if (buf && fp != MP3_FILE_NULL)
+    {
+#ifdef MP3_PLAYER_USING_FAST_START
+        /* tags and vbr header were skipped to start decoding early,unless the track was parsed ahead */
+        if (player.info_ready == 0 &&
+            mp3_player_info_load(&player, uri, fp, &player.bg_info, buf, MP3_BG_BUFFER_SIZE) == RT_EOK)
+            player.info_ready = 1; /* applied by the player thread */
+        if (player.info_ready != 0)
+            mp3_seek_index_build(player.seek_index, fp, player.bg_info.audio_start, player.bg_info.data_end,
+                                 buf, MP3_BG_BUFFER_SIZE, &player.bg_cancel);
+#else
+        mp3_seek_index_build(player.seek_index, fp, player.bg_info.audio_start, player.bg_info.data_end,
+                             buf, MP3_BG_BUFFER_SIZE, &player.bg_cancel);
+#endif
+#ifdef MP3_PLAYER_USING_EXACT_DURATION
+        mp3_player_bg_exact(uri);
+#endif
+    }
+
+    if (fp != MP3_FILE_NULL)
+        mp3_file_close(fp);
+    rt_free(buf);
+    rt_free(uri);
+    player.bg_running = 0;
+    rt_completion_done(&player.bg_done);
+}
+
+/**
+ * @description: run one background job,the previous one must be stopped
+ * @param {struct mp3_player} *player
+ * @param {void (*)(void *)} entry
+ * @param {void *}parameter
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_bg_run(struct mp3_player *player, void (*entry)(void *), void *parameter)
+{
+    player->bg_cancel = 0;
+    player->bg_running = 1;
+    rt_completion_init(&player->bg_done);
+    player->bg_tid = rt_thread_create("mp3_bg",
+                                      entry,
+                                      parameter,
+                                      MP3_BG_THREAD_STACK_SIZE,
+                                      MP3_BG_THREAD_PRIORITY, 10);
+    if (player->bg_tid == RT_NULL)
+    {
+        player->bg_running = 0;
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(player->bg_tid);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: start background work for current file
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_bg_start(struct mp3_player *player)
+{
+    char *uri;
+
+    mp3_seek_index_reset(player->seek_index);
+    uri = rt_strdup(player->uri);
+    if (uri == RT_NULL)
+        return;
+
+    if (mp3_player_bg_run(player, mp3_player_bg_entry, uri) != RT_EOK)
+        rt_free(uri);
+}
+
+/**
+ * @description: cancel background work and wait for it to finish
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_bg_stop(struct mp3_player *player)
+{
+    if (player->bg_tid == RT_NULL)
+        return;
+
+    player->bg_cancel = 1;
+    rt_completion_wait(&player->bg_done, RT_WAITING_FOREVER);
+    player->bg_tid = RT_NULL;
+}
+
+#ifdef MP3_PLAYER_USING_GAPLESS
+/**
+ * @description: background thread, opens and parses the queued file while the current one still plays
+ * @param {void *}parameter None
+ * @return None
+ */
+static void mp3_player_next_entry(void *parameter)
+{
+    uint8_t *buf;
+    mp3_file_t fp;
+
+    buf = rt_malloc(MP3_BG_BUFFER_SIZE);
+    fp = mp3_file_open(player.prepared_uri);
+    if (buf && fp != MP3_FILE_NULL &&
+        mp3_player_info_load(&player, player.prepared_uri, fp, &player.prepared_info, buf, MP3_BG_BUFFER_SIZE) == RT_EOK)
+    {
+        player.prepared_fp = fp;
+        fp = MP3_FILE_NULL;
+    }
+
+    if (fp != MP3_FILE_NULL)
+        mp3_file_close(fp);
+    rt_free(buf);
+    player.bg_running = 0;
+    rt_completion_done(&player.bg_done);
+}
+
+/**
+ * @description: release the track parsed ahead,its uri goes back to the queue if nothing else was queued meanwhile
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_prepared_drop(struct mp3_player *player)
+{
+    char *uri;
+
+    if (player->prepared_fp != MP3_FILE_NULL)
+    {
+        mp3_file_close(player->prepared_fp);
+        player->prepared_fp = MP3_FILE_NULL;
+    }
+    uri = player->prepared_uri;
+    player->prepared_uri = RT_NULL;
+    if (uri == RT_NULL)
+        return;
+
+    rt_enter_critical();
+    if (player->next_seq == player->prepared_seq && player->next_uri == RT_NULL)
+    {
+        player->next_uri = uri;
+        uri = RT_NULL;
+    }
+    rt_exit_critical();
+    if (uri)
+        rt_free(uri);
+}
+
+/**
+ * @description: open and parse the queued file once the background work of current file is done,
+ *               so only the decoder switch is left at the end of current file
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_next_prepare(struct mp3_player *player)
+{
+    if (player->next_seq == player->prepared_seq && player->prepared_uri)
+        return; /* already prepared */
+    if (player->bg_running)
+        return; /* seek index still building,try later */
+
+    mp3_player_bg_stop(player);
+    mp3_player_prepared_drop(player);
+
+    rt_enter_critical();
+    player->prepared_uri = player->next_uri;
+    player->prepared_seq = player->next_seq;
+    player->next_uri = RT_NULL;
+    rt_exit_critical();
+    if (player->prepared_uri == RT_NULL)
+        return;
+
+    mp3_player_bg_run(player, mp3_player_next_entry, RT_NULL);
+}
+#endif
+
+/**
+ * @description: show mp3 info
+ * @param None
+ * @return None
+ */
+void mp3_info_show(void)
+{
+    mp3_info_print(player.mp3_info);
+}
+
+/**
+ * @description: show mp3 current seconds
+ * @param None
+ * @return None
+ */
+void mp3_disp_time(void)
+{
+    uint32_t cur_seconds;
+    cur_seconds = mp3_get_cur_seconds();
+    rt_kprintf("%02d:%02d / %02d:%02d\r\n", cur_seconds / 60, cur_seconds % 60, player.mp3_info.total_seconds / 60, player.mp3_info.total_seconds % 60);
+}
+
+/**
+ * @description: open sound device if it is not open yet
+ * @param {struct mp3_player} *player
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_device_open(struct mp3_player *player)
+{
+    rt_err_t result;
+    struct rt_audio_caps caps;
+
+    if (player->device_opened)
+        return RT_EOK;
+
+    /* find device */
+    player->audio_device = rt_device_find(MP3_SOUND_DEVICE_NAME);
+    if (player->audio_device == RT_NULL)
+    {
+        LOG_E("audio_device %s not found", MP3_SOUND_DEVICE_NAME);
+        return -RT_ERROR;
+    }
+
+    /* open sound device */
+    result = rt_device_open(player->audio_device, RT_DEVICE_OFLAG_WRONLY);
+    if (result != RT_EOK)
+    {
+        LOG_E("open %s audio_device failed", MP3_SOUND_DEVICE_NAME);
+        return result;
+    }
+    player->device_opened = 1;
+
+    /* set sampletate,channels, samplebits */
+    caps.main_type = AUDIO_TYPE_OUTPUT;
+    caps.sub_type = AUDIO_DSP_PARAM;
+    caps.udata.config.samplerate = 44100;
+    caps.udata.config.channels = 2;
+    caps.udata.config.samplebits = 16;
+    rt_device_control(player->audio_device, AUDIO_CTL_CONFIGURE, &caps);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: close sound device
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_device_close(struct mp3_player *player)
+{
+    if (!player->device_opened)
+        return;
+
+    mp3_pcm_output_release(player->pcm);
+    rt_device_close(player->audio_device);
+    player->device_opened = 0;
+    LOG_D("close %s", MP3_SOUND_DEVICE_NAME);
+}
+
+/**
+ * @description: open mp3 player
+ * @param {struct mp3_player} *player
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_open(struct mp3_player *player)
+{
+    rt_err_t result = RT_EOK;
+
+    player->start_tick = rt_tick_get();
+
+    /* sound device stays open between tracks */
+    result = mp3_player_device_open(player);
+    if (result != RT_EOK)
+        return result;
+
+    /* open file */
+    player->fp = mp3_file_open(player->uri);
+    if (player->fp == MP3_FILE_NULL)
+    {
+        LOG_E("open file %s failed", player->uri);
+        return -RT_ERROR;
+    }
+
+    /* the decoder is allocated once, only its stream state is reset */
+    mp3_decoder_reset(player->mp3_decoder);
+
+    mp3_pcm_output_start(player->pcm, player->audio_device);
+
+    return RT_EOK;
+}
+
+/**
+ * @description:close mp3 player,sound device is closed later if it stays idle
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_close(struct mp3_player *player)
+{
+    mp3_player_bg_stop(player);
+#ifdef MP3_PLAYER_USING_GAPLESS
+    mp3_player_prepared_drop(player);
+#endif
+    mp3_readahead_stop(player->readahead);
+    mp3_pcm_output_stop(player->pcm);
+    if (player->fp != MP3_FILE_NULL)
+    {
+        mp3_file_close(player->fp);
+        player->fp = MP3_FILE_NULL;
+    }
+    LOG_D("close mp3 player");
+}
+
+/**
+ * @description: set callback of player notifications
+ * @param {mp3_player_notify_t} notify RT_NULL to remove
+ * @param {void} *user passed to the callback
+ * @return None
+ */
+void mp3_player_notify_set(mp3_player_notify_t notify, void *user)
+{
+    rt_enter_critical();
+    player.notify = notify;
+    player.notify_user = user;
+    rt_exit_critical();
+}
+
+/**
+ * @description: raise a player notification,called in the player thread
+ * @param {struct mp3_player} *player
+ * @param {int} notify enum MP3_PLAYER_NOTIFY
+ * @return None
+ */
+static void mp3_player_notify(struct mp3_player *player, int notify)
+{
+    if (player->notify)
+        player->notify(notify, player->notify_user);
+}
+
+/**
+ * @description: get time from play start to the first pcm written to the sound device
+ * @param None
+ * @return milliseconds,0 if no pcm has been written yet
+ */
+uint32_t mp3_player_first_sample_ms(void)
+{
+    rt_tick_t first_tick;
+
+    if (player.pcm == RT_NULL || (first_tick = player.pcm->first_tick) == 0)
+        return 0;
+    return (first_tick - player.start_tick) * 1000 / RT_TICK_PER_SECOND;
+}
+
+#ifdef MP3_PLAYER_USING_FAST_START
+/**
+ * @description: take over metadata parsed by the background thread
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_info_apply(struct mp3_player *player)
+{
+    uint8_t vbr_frame;
+
+    player->info_ready = 2;
+    player->mp3_info = player->bg_info;
+    mp3_info_print(player->mp3_info);
+
+    /* decoding started at the vbr header frame,which decodes to silence */
+    vbr_frame = (player->mp3_info.audio_start != player->mp3_info.data_start);
+    if (!vbr_frame || player->track_frames > 0)
+    {
+        mp3_player_trim_init(player, player->track_frames - vbr_frame);
+    }
+    else
+    {
+        mp3_player_trim_init(player, 0);
+        if (player->trim_remain != UINT32_MAX)
+            player->trim_skip += player->mp3_info.outsamples / 2;
+    }
+
+    mp3_player_notify(player, MP3_PLAYER_NOTIFY_METADATA);
+}
+#endif
+
+#ifdef MP3_PLAYER_USING_EXACT_DURATION
+/**
+ * @description: take over exact duration counted by the background thread
+ * @param {struct mp3_player} *player
+ * @return None
+ */
+static void mp3_player_duration_apply(struct mp3_player *player)
+{
+    player->duration_ready = 2;
+    player->mp3_info.total_frames = player->bg_info.total_frames;
+    player->mp3_info.total_samples = player->bg_info.total_samples;
+    player->mp3_info.total_seconds = player->bg_info.total_seconds;
+    player->mp3_info.bitrate = player->bg_info.bitrate;
+    player->mp3_info.exact = 1;
+
+    mp3_player_notify(player, MP3_PLAYER_NOTIFY_DURATION);
+}
+#endif
+
+/**
+ * @description: start decoding current file from its first audio frame
+ * @param {struct mp3_player} *player
+ * @param {const mp3_info_t} *info mp3 info parsed ahead,RT_NULL to parse it now
+ * @return None
+ */
+static void mp3_player_track_start(struct mp3_player *player, const mp3_info_t *info)
 {
     rt_err_t result = RT_EOK;
-    rt_int32_t size;
-    int event;
 
-    /* decoder relate */
-    int i = 0;
-    int err;
+#ifdef MP3_PLAYER_USING_FAST_START
+    if (info == RT_NULL)
+    {
+        /* only skip the ID3v2 tag, everything else is parsed in background */
+        memset(&player->mp3_info, 0, sizeof(mp3_info_t));
+        player->mp3_info.file_size = mp3_file_size(player->fp);
+        player->mp3_info.data_start = mp3_tag_data_start(player->fp);
+        player->mp3_info.audio_start = player->mp3_info.data_start;
+        player->info_ready = 0;
+        player->duration_ready = 0;
+        mp3_player_bg_start(player);
+    }
+    else
+#endif
+    {
+        /* get current mp3 basic info  */
+        if (info)
+            player->mp3_info = *info;
+        else
+            result = mp3_player_info_load(player, player->uri, player->fp, &player->mp3_info,
+                                          player->in_buffer, MP3_INPUT_BUFFER_SIZE);
+        if (result == RT_EOK)
+        {
+            mp3_info_print(player->mp3_info);
+#ifdef MP3_PLAYER_USING_FAST_START
+            player->info_ready = 2; /* parsed ahead,nothing left for the background thread */
+#endif
+            /* index frames for seeking while playing */
+            player->bg_info = player->mp3_info;
+            player->duration_ready = 0;
+            mp3_player_bg_start(player);
+        }
+        mp3_player_notify(player, MP3_PLAYER_NOTIFY_METADATA);
+    }
+    player->seek_pending = 0;
+    player->preroll_frames = 0;
+    player->track_frames = 0;
+    player->synced = 0;
+    memset(&player->sync_header, 0, sizeof(mp3_frame_header_t));
+    mp3_player_trim_init(player, 0);
+    mp3_player_position_set(player, 0);
+
+    mp3_file_seek(player->fp, player->mp3_info.audio_start, SEEK_SET);
+    mp3_readahead_start(player->readahead, player->fp, player->mp3_info.audio_start);
+}
+
+#ifdef MP3_PLAYER_USING_GAPLESS
+/**
+ * @description: switch to the queued file,sound device and pcm ring keep running
+ * @param {struct mp3_player} *player
+ * @return the error code,0 on success
+ */
+static rt_err_t mp3_player_track_next(struct mp3_player *player)
+{
+    char *uri;
+    mp3_file_t fp = MP3_FILE_NULL;
+
+    if (player->prepared_uri == RT_NULL && player->next_uri == RT_NULL)
+        return RT_ERROR;
+
+    /* waits for the queued file to be parsed if it is still in progress */
+    mp3_player_bg_stop(player);
+    if (player->prepared_uri && player->prepared_seq == player->next_seq)
+    {
+        uri = player->prepared_uri;
+        fp = player->prepared_fp;
+        player->prepared_uri = RT_NULL;
+        player->prepared_fp = MP3_FILE_NULL;
+    }
+    else
+    {
+        /* queue changed after it was parsed */
+        mp3_player_prepared_drop(player);
+        uri = mp3_player_queue_pop(player);
+        if (uri == RT_NULL)
+            return RT_ERROR;
+    }
+
+    mp3_readahead_stop(player->readahead);
+    mp3_file_close(player->fp);
+    rt_free(player->uri);
+    player->uri = uri;
+
+    player->fp = fp;
+    if (player->fp == MP3_FILE_NULL)
+    {
+        player->fp = mp3_file_open(player->uri);
+        if (player->fp == MP3_FILE_NULL)
+        {
+            LOG_E("open file %s failed", player->uri);
+            return RT_ERROR;
+        }
+    }
+
+    /* encoder delay is counted from a decoder without history */
+    mp3_decoder_reset(player->mp3_decoder);
+
+    LOG_I("play next, uri=%s", player->uri);
+    mp3_player_track_start(player, fp != MP3_FILE_NULL ? &player->prepared_info : RT_NULL);
+
+    return RT_EOK;
+}
+#endif
+
+/**
+ * @description: find the next frame in the input window,bad data before it is dropped
+ * @param {struct mp3_player} *player
+ * @return the error code,RT_EOK if a frame starts at the read pointer
+ */
+static rt_err_t mp3_player_sync(struct mp3_player *player)
+{
+    decode_oper_t *oper = &player->decode_oper;
+    mp3_frame_header_t header;
+    uint32_t offset;
+    uint8_t eof;
+    rt_err_t ret;
+
+    /* in sync the next frame follows the last one,one header check is enough */
+    if (player->synced)
+    {
+        if (oper->bytes_left >= MP3_FRAME_HEADER_SIZE &&
+            mp3_frame_header_parse(oper->read_ptr, &header) == RT_EOK &&
+            mp3_frame_header_match(&player->sync_header, &header))
+            return RT_EOK;
+        player->synced = 0;
+        player->resyncs++;
+        MP3_STATS_ADD(resyncs, 1);
+    }
+
+    eof = player->input->eof && oper->bytes_left == mp3_input_used(player->input);
+    ret = mp3_frame_sync(oper->read_ptr, oper->bytes_left, eof,
+                         player->sync_header.samplerate ? &player->sync_header : RT_NULL, &offset);
+    if (offset > 0)
+    {
+        mp3_input_consume(player->input, offset);
+        oper->read_ptr += offset;
+        oper->bytes_left -= offset;
+        player->resync_bytes += offset;
+    }
+    if (ret != RT_EOK)
+        return ret;
+
+    mp3_frame_header_parse(oper->read_ptr, &player->sync_header);
+    player->synced = 1;
+    return RT_EOK;
+}
+
+/**
+ * @description: read,sync and decode one frame from the input ring
+ * @param {struct mp3_player} *player
+ * @param {short} *out pcm of the frame
+ * @param {int} *eof set to 1 once the input is used up
+ * @return {int} ERR_MP3_NONE if a frame was decoded,else the helix error,
+ *               ERR_MP3_INDATA_UNDERFLOW if no whole frame is buffered
+ */
+static int mp3_player_decode_frame(struct mp3_player *player, short *out, int *eof)
+{
+    decode_oper_t *oper = &player->decode_oper;
+    uint8_t *frame_start;
+    uint32_t bytes;
+    int err = ERR_MP3_INDATA_UNDERFLOW;
+
+    /* keep at least a frame window buffered */
+    if (mp3_readahead_fill(player->readahead, MAINBUF_SIZE, rt_tick_from_millisecond(MP3_INPUT_WAIT_MS)) != RT_EOK)
+        return err;
+    oper->read_ptr = mp3_input_read_ptr(player->input, &bytes);
+    oper->bytes_left = bytes;
+
+    /* find syncword, a damaged region is skipped at once */
+    if (mp3_player_sync(player) != RT_EOK)
+        goto __exit;
+
+    /* start decode */
+    frame_start = oper->read_ptr;
+    MP3_STATS_TIME(decode, err = MP3Decode(player->mp3_decoder, &oper->read_ptr, &oper->bytes_left, out, 0));
+    mp3_input_consume(player->input, oper->read_ptr - frame_start);
+    switch (err)
+    {
+    case ERR_MP3_NONE:
+        MP3_STATS_ADD(frames, 1);
+        break;
+    case ERR_MP3_INDATA_UNDERFLOW:
+        LOG_D("ERR_MP3_INDATA_UNDERFLOW");
+        if (player->input->eof)
+            *eof = 1; /* truncated last frame */
+        break;
+    case ERR_MP3_MAINDATA_UNDERFLOW:
+        LOG_D("ERR_MP3_MAINDATA_UNDERFLOW");
+        break;
+    default:
+        LOG_D("%s", MP3Decode_ERR_CODE_get(err));
+        /* bad frame behind a good header, look for the next confirmed one */
+        if (oper->bytes_left > 0)
+            mp3_input_consume(player->input, 1);
+        if (player->synced)
+        {
+            player->synced = 0;
+            player->resyncs++;
+            MP3_STATS_ADD(resyncs, 1);
+        }
+        break;
+    }
+
+__exit:
+    if (player->input->eof && mp3_input_used(player->input) == 0)
+        *eof = 1;
+    return err;
+}
+
+/**
+ * @description: get the stack high-water mark of a thread,the unused stack keeps the '#' fill of rt_thread_init
+ * @param {rt_thread_t} thread
+ * @return bytes of stack used at most
+ */
+static uint32_t mp3_bench_stack_used(rt_thread_t thread)
+{
+    rt_uint8_t *stack = (rt_uint8_t *)thread->stack_addr;
+    uint32_t unused = 0;
+
+#ifdef ARCH_CPU_STACK_GROWS_UPWARD
+    while (unused < thread->stack_size && stack[thread->stack_size - 1 - unused] == '#')
+        unused++;
+#else
+    while (unused < thread->stack_size && stack[unused] == '#')
+        unused++;
+#endif
+
+    return thread->stack_size - unused;
+}
+
+/**
+ * @description: decode a file without playing it and time every frame,called in the player thread
+ * @param {struct mp3_player} *player
+ * @param {struct mp3_bench} *bench
+ * @return None
+ */
+static void mp3_player_bench_run(struct mp3_player *player, struct mp3_bench *bench)
+{
+#ifdef RT_USING_HEAP
+#if RT_VER_NUM >= 0x40101
+    rt_size_t total, used, max_used, max_used_start;
+#else
+    rt_uint32_t total, used, max_used, max_used_start;
+#endif
+#endif
+    rt_uint32_t start, elapsed;
+    rt_tick_t tick;
+    uint32_t resyncs, offset;
+    short *pcm;
+    int err, eof = 0;
+
+    if (player->state != PLAYER_STATE_STOPED)
+    {
+        bench->result = -RT_EBUSY;
+        return;
+    }
 
-    player.in_buffer = rt_malloc(MP3_INPUT_BUFFER_SIZE);
-    if (player.in_buffer == RT_NULL)
+#ifdef RT_USING_HEAP
+    /* the peak of the heap can not be reset,only its growth is due to the run */
+    rt_memory_info(&total, &used, &max_used_start);
+#endif
+    /* helix writes a whole frame,no pcm ring is needed */
+    pcm = rt_malloc(MP3_OUTPUT_BUFFER_SIZE);
+    if (pcm == RT_NULL)
     {
-        LOG_E("can not malloc input buffer for mp3 player.");
+        bench->result = -RT_ENOMEM;
         return;
     }
-    player.out_buffer = rt_malloc(MP3_OUTPUT_BUFFER_SIZE);
-    if (player.out_buffer == RT_NULL)
+    player->fp = mp3_file_open(bench->uri);
+    if (player->fp == MP3_FILE_NULL)
+    {
+        LOG_E("open file %s failed", bench->uri);
+        bench->result = -RT_ERROR;
+        goto __exit;
+    }
+
+    /* stream state of a track start,tags are skipped but not parsed */
+    mp3_decoder_reset(player->mp3_decoder);
+    player->synced = 0;
+    memset(&player->sync_header, 0, sizeof(mp3_frame_header_t));
+    resyncs = player->resyncs;
+    offset = mp3_tag_data_start(player->fp);
+    mp3_file_seek(player->fp, offset, SEEK_SET);
+    mp3_readahead_start(player->readahead, player->fp, offset);
+
+    bench->cycles = mp3_stats_clock_init();
+    tick = rt_tick_get();
+    while (!eof)
+    {
+        start = mp3_stats_clock();
+        err = mp3_player_decode_frame(player, pcm, &eof);
+        elapsed = mp3_stats_clock() - start;
+        if (err != ERR_MP3_NONE)
+        {
+            if (err != ERR_MP3_INDATA_UNDERFLOW && err != ERR_MP3_MAINDATA_UNDERFLOW)
+                bench->errors++;
+            continue;
+        }
+
+        MP3GetLastFrameInfo(player->mp3_decoder, &player->mp3_frameinfo);
+        if (bench->frames == 0 || elapsed < bench->frame_min)
+            bench->frame_min = elapsed;
+        if (elapsed > bench->frame_max)
+            bench->frame_max = elapsed;
+        bench->frame_total += elapsed;
+        bench->frames++;
+        bench->samples += player->mp3_frameinfo.outputSamps / player->mp3_frameinfo.nChans;
+        bench->samplerate = player->mp3_frameinfo.samprate;
+    }
+    bench->ticks = rt_tick_get() - tick;
+    bench->resyncs = player->resyncs - resyncs;
+    mp3_readahead_stop(player->readahead);
+    bench->result = bench->frames > 0 ? RT_EOK : -RT_ERROR;
+
+__exit:
+    if (player->fp != MP3_FILE_NULL)
+    {
+        mp3_file_close(player->fp);
+        player->fp = MP3_FILE_NULL;
+    }
+#ifdef RT_USING_HEAP
+    rt_memory_info(&total, &used, &max_used);
+    bench->heap_peak = max_used;
+    bench->heap_grown = max_used - max_used_start;
+#endif
+    rt_free(pcm);
+    bench->stack_size = rt_thread_self()->stack_size;
+    bench->stack_used = mp3_bench_stack_used(rt_thread_self());
+}
+
+/**
+ * @description: handle a coalesced command,the latest value is taken
+ * @param {struct mp3_player} *player
+ * @param {int} type MSG_SEEK or MSG_VOLUME
+ * @return None
+ */
+static void mp3_player_command_handle(struct mp3_player *player, int type)
+{
+    uint32_t ms;
+
+    if (type == MSG_VOLUME)
     {
-        LOG_E("can not malloc output buffer for mp3 player.");
+        /* a later call queues a new message */
+        player->volume_queued = 0;
+        mp3_player_volume_apply(player);
         return;
     }
-    memset(player.in_buffer, 0, MP3_INPUT_BUFFER_SIZE);
-    memset(player.out_buffer, 0, MP3_OUTPUT_BUFFER_SIZE);
 
-    player.mq = rt_mq_create("mp3_mq", 10, sizeof(struct play_msg), RT_IPC_FLAG_FIFO);
+    rt_enter_critical();
+    ms = player->seek_request_ms;
+    player->seek_queued = 0;
+    rt_exit_critical();
+    /* the track may have stopped since the seek was queued */
+    if (mp3_player_seek_prepare(player, ms) == RT_EOK)
+        mp3_player_position_set(player, ms); /* shown at once,also while paused */
+}
+
+/**
+ * @description: player event handler
+ * @param {struct mp3_player} *player
+ * @param {int} timeout
+ * @return {int} mp3 event
+ */
+static int mp3_player_event_handler(struct mp3_player *player, int timeout)
+{
+    int event;
+    rt_err_t result;
+    struct play_msg msg;
+#if (LOG_LVL >= DBG_LOG)
+    rt_uint8_t last_state;
+#endif
+
+    /* seek,volume and bench commands are handled here and do not end the wait */
+    while (1)
+    {
+        result = rt_mq_recv(player->mq, &msg, sizeof(struct play_msg), timeout);
+        /* since 5.0 the received size is returned,errors are negative */
+        #if RT_VER_NUM > 0x50000
+        if (result < 0)
+        #else
+        if (RT_EOK != result)
+        #endif
+        {
+            event = PLAYER_EVENT_NONE;
+            return event;
+        }
+        if (msg.type == MSG_BENCH)
+        {
+            mp3_player_bench_run(player, (struct mp3_bench *)msg.data);
+            rt_completion_done(&player->ack);
+            continue;
+        }
+        if (msg.type != MSG_SEEK && msg.type != MSG_VOLUME)
+            break;
+        mp3_player_command_handle(player, msg.type);
+    }
+#if (LOG_LVL >= DBG_LOG)
+    last_state = player->state;
+#endif
+    switch (msg.type)
+    {
+    case MSG_START:
+        event = PLAYER_EVENT_PLAY;
+        player->state = PLAYER_STATE_PLAYING;
+        break;
+    case MSG_STOP:
+        event = PLAYER_EVENT_STOP;
+        player->state = PLAYER_STATE_STOPED;
+        break;
+
+    case MSG_PAUSE:
+        event = PLAYER_EVENT_PAUSE;
+        player->state = PLAYER_STATE_PAUSED;
+        break;
+
+    case MSG_RESUME:
+        event = PLAYER_EVENT_RESUME;
+        player->state = PLAYER_STATE_PLAYING;
+        break;
+
+    default:
+        event = PLAYER_EVENT_NONE;
+        break;
+    }
+    /* the sender waits for it */
+    rt_completion_done(&player->ack);
+#if (LOG_LVL >= DBG_LOG)
+    LOG_D("EVENT:%s, STATE:%s -> %s", event_str[event], state_str[last_state], state_str[player->state]);
+#endif
+
+    return event;
+}
+
+/**
+ * @description: mp3 player thread
+ * @param {void *}parameter
+ * @return None
+ */
+static void mp3_player_entry(void *parameter)
+{
+    rt_err_t result = RT_EOK;
+    int event;
+    int eof;
+    char *next_uri = RT_NULL;
+
+    /* decoder relate */
+    int i = 0;
+    int err;
+
+    player.fp = MP3_FILE_NULL;
+#ifdef MP3_PLAYER_USING_GAPLESS
+    player.prepared_fp = MP3_FILE_NULL;
+#endif
+
+    /* helix must always see a whole frame contiguous,
+       mp3 info is parsed with up to MP3_INPUT_BUFFER_SIZE bytes into the ring */
+    player.input = &input;
+    if (mp3_input_init(player.input, MP3_INPUT_RING_SIZE > MP3_INPUT_BUFFER_SIZE ? MP3_INPUT_RING_SIZE : MP3_INPUT_BUFFER_SIZE,
+                       MP3_INPUT_READ_SIZE, MAINBUF_SIZE) != RT_EOK)
+        return;
+    player.in_buffer = player.input->buffer;
+
+    player.readahead = &readahead;
+    if (mp3_readahead_init(player.readahead, player.input) != RT_EOK)
+        goto __exit;
+
+    player.mq = rt_mq_create("mp3_mq", sizeof(struct play_msg), 10, RT_IPC_FLAG_FIFO);
     if (player.mq == RT_NULL)
         goto __exit;
 
@@ -489,16 +1723,55 @@ static void mp3_player_entry(void *parameter)
     if (player.lock == RT_NULL)
         goto __exit;
 
+    /* decoded frames are written straight into the pcm ring */
+    player.pcm = &pcm_output;
+    if (mp3_pcm_output_init(player.pcm, MP3_OUTPUT_BUFFER_SIZE, MP3_PCM_RING_FRAMES) != RT_EOK)
+        goto __exit;
+
+    player.seek_index = &seek_index;
+    if (mp3_seek_index_init(player.seek_index, MP3_SEEK_INDEX_ENTRIES) != RT_EOK)
+        goto __exit;
+
+    /* one decoder for all tracks, reset between them */
+    player.mp3_decoder = MP3InitDecoder();
+    if (player.mp3_decoder == 0)
+    {
+        LOG_E("initialize helix mp3 decoder fail!");
+        goto __exit;
+    }
+
+#ifdef MP3_PLAYER_USING_CACHE
+    /* playback goes on without it */
+    if (mp3_cache_open(&cache, MP3_PLAYER_CACHE_PATH, MP3_CACHE_SLOTS) == RT_EOK)
+        player.cache = &cache;
+#endif
+
+#ifdef MP3_PLAYER_USING_STATS
+    mp3_stats_clock_init();
+#endif
+
     player.volume = MP3_PLAYER_VOLUME_DEFAULT;
     /* set volume */
-    mp3_player_volume_set(player.volume);
+    mp3_player_volume_apply(&player);
 
     while (1)
     {
-        /* wait play event forever */
-        event = mp3_player_event_handler(&player, RT_WAITING_FOREVER);
-        if (event != PLAYER_EVENT_PLAY)
-            continue;
+        if (next_uri == RT_NULL)
+        {
+            /* wait play event, the sound device is closed once it stays idle */
+            event = mp3_player_event_handler(&player, player.device_opened ? (int)rt_tick_from_millisecond(MP3_PLAYER_IDLE_TIMEOUT * 1000) : RT_WAITING_FOREVER);
+            if (event == PLAYER_EVENT_NONE)
+                mp3_player_device_close(&player);
+            if (event != PLAYER_EVENT_PLAY)
+                continue;
+        }
+        else
+        {
+            /* last track ended, play the queued one */
+            rt_free(player.uri);
+            player.uri = next_uri;
+            next_uri = RT_NULL;
+        }
 
         /* open mp3 player */
         result = mp3_player_open(&player);
@@ -509,81 +1782,58 @@ static void mp3_player_entry(void *parameter)
             continue;
         }
         LOG_I("play start, uri=%s", player.uri);
-        /* get current mp3 basic info  */
-        if (mp3_get_info(&player) == RT_EOK)
-        {
-            mp3_info_print(player.mp3_info);
-        }
-        
-        fseek(player.fp, player.mp3_info.data_start, SEEK_SET);
-        size = fread(player.in_buffer, 1, MP3_INPUT_BUFFER_SIZE, player.fp);
-        if (size <= 0)
-            goto __exit;
-
-        /* set read ptr to inputbuffer */
-        player.decode_oper.read_ptr = player.in_buffer;
-        player.decode_oper.bytes_left = size;
+        mp3_player_track_start(&player, RT_NULL);
 
         while (1)
         {
+            eof = 0;
             event = mp3_player_event_handler(&player, RT_WAITING_NO);
             switch (event)
             {
             case PLAYER_EVENT_NONE:
             {
-                /* find syncword */
-                player.decode_oper.read_offset = MP3FindSyncWord(player.decode_oper.read_ptr, player.decode_oper.bytes_left);
-                if (player.decode_oper.read_offset < 0) /* can not find syncword */
+                if (player.seek_pending)
+                    mp3_player_seek_apply(&player);
+#ifdef MP3_PLAYER_USING_FAST_START
+                if (player.info_ready == 1)
+                    mp3_player_info_apply(&player);
+#endif
+#ifdef MP3_PLAYER_USING_EXACT_DURATION
+                if (player.duration_ready == 1 && player.info_ready != 1)
+                    mp3_player_duration_apply(&player);
+#endif
+#ifdef MP3_PLAYER_USING_GAPLESS
+                if (player.next_uri || player.prepared_uri)
+                    mp3_player_next_prepare(&player);
+#endif
+
+                /* wait until the output stage has room for a frame */
+                player.out_buffer = (uint16_t *)mp3_pcm_output_reserve(player.pcm, rt_tick_from_millisecond(MP3_PCM_WAIT_MS));
+                if (player.out_buffer == RT_NULL)
+                    break;
+
+                MP3_STATS_LEVEL(input, mp3_input_used(player.input) * 100 / player.input->size);
+                if (!player.pcm->zero_copy)
+                    MP3_STATS_LEVEL(pcm, mp3_pcm_output_used(player.pcm) * 100 / player.pcm->size);
+                err = mp3_player_decode_frame(&player, (short *)player.out_buffer, &eof);
+                if (err == ERR_MP3_MAINDATA_UNDERFLOW)
                 {
-                    size = fread(player.in_buffer, 1, MP3_INPUT_BUFFER_SIZE, player.fp);
-                    if (size <= 0)
-                        goto __exit;
-                    player.decode_oper.read_ptr = player.in_buffer;
-                    player.decode_oper.bytes_left = size;
-                    continue;
+                    /* do nothing - next call to decode will provide more mainData */
+                    if (player.preroll_frames)
+                        player.preroll_frames--;
                 }
-
-                player.decode_oper.read_ptr += player.decode_oper.read_offset;   /* move read pointer to syncword */
-                player.decode_oper.bytes_left -= player.decode_oper.read_offset; /* data size after syncword */
-                if (player.decode_oper.bytes_left < MAINBUF_SIZE * 2)            /* append data */
+                else if (err != ERR_MP3_NONE)
                 {
-                    i = (uint32_t)(player.decode_oper.bytes_left) & 3;
-                    if (i)
-                        i = 4 - i; /* bytes need to append */
-                    memcpy(player.in_buffer + i, player.decode_oper.read_ptr, player.decode_oper.bytes_left);
-                    player.decode_oper.read_ptr = player.in_buffer + i;
-                    size = fread(player.in_buffer + player.decode_oper.bytes_left + i, 1, MP3_INPUT_BUFFER_SIZE - player.decode_oper.bytes_left - i, player.fp); /* copy at aligned position */
-                    player.decode_oper.bytes_left += size;
+                    break;
                 }
-                /* start decode */
-                err = MP3Decode(player.mp3_decoder, &player.decode_oper.read_ptr, &player.decode_oper.bytes_left, (short *)player.out_buffer, 0);
-                if (err != ERR_MP3_NONE)
+                else if (player.preroll_frames) /* refills the bit reservoir after a seek,not played */
                 {
-                    switch (err)
-                    {
-                    case ERR_MP3_INDATA_UNDERFLOW:
-                        LOG_D("ERR_MP3_INDATA_UNDERFLOW");
-                        size = fread(player.in_buffer, 1, MP3_INPUT_BUFFER_SIZE, player.fp); /* append data */
-                        player.decode_oper.read_ptr = player.in_buffer;
-                        player.decode_oper.bytes_left = size;
-                        break;
-                    case ERR_MP3_MAINDATA_UNDERFLOW:
-                        /* do nothing - next call to decode will provide more mainData */
-                        LOG_D("ERR_MP3_MAINDATA_UNDERFLOW");
-                        break;
-                    default:
-                        LOG_D("%s", MP3Decode_ERR_CODE_get(err));
-                        if (player.decode_oper.bytes_left > 0)
-                        {
-                            player.decode_oper.bytes_left--;
-                            player.decode_oper.read_ptr++;
-                        }
-                        break;
-                    }
+                    player.preroll_frames--;
                 }
                 else /* decode success */
                 {
                     MP3GetLastFrameInfo(player.mp3_decoder, &player.mp3_frameinfo); /* get decode info */
+                    player.track_frames++;
                     player.mp3_info.outsamples = player.mp3_frameinfo.outputSamps;
                     if (player.mp3_info.outsamples > 0)
                     {
@@ -598,38 +1848,47 @@ static void mp3_player_entry(void *parameter)
                             player.mp3_info.outsamples *= 2;
                         }
                     }
-                    if (player.mp3_frameinfo.samprate != player.mp3_info.samplerate && player.mp3_info.vbr)
+                    /* drop encoder delay and padding */
+                    player.mp3_info.outsamples = mp3_player_trim(&player, player.mp3_info.outsamples / 2) * 2;
+                    if (player.trim_remain == 0)
+                        eof = 1;
+                    if (player.mp3_info.outsamples > 0)
                     {
-                        /* set samplerate by frameinfo*/
+                        /* set samplerate by frameinfo */
                         player.mp3_info.samplerate = player.mp3_frameinfo.samprate;
-                        struct rt_audio_caps caps;
-                        /* set sampletate,channels, samplebits */
-                        caps.main_type = AUDIO_TYPE_OUTPUT;
-                        caps.sub_type = AUDIO_DSP_PARAM;
-                        caps.udata.config.samplerate = player.mp3_info.samplerate;
-                        caps.udata.config.channels = 2;
-                        caps.udata.config.samplebits = 16;
-                        rt_device_control(player.audio_device, AUDIO_CTL_CONFIGURE, &caps);
+                        mp3_pcm_output_configure(player.pcm, player.mp3_info.samplerate);
+                        /* queue exactly the decoded pcm for the output thread */
+                        mp3_pcm_output_commit(player.pcm, player.mp3_info.outsamples * sizeof(short));
                     }
-                    /* write pcm data to soundcard */
-                    rt_device_write(player.audio_device, 0, (uint8_t *)player.out_buffer, MP3_OUTPUT_BUFFER_SIZE);
-                }
-                if (ftell(player.fp) >= player.mp3_info.file_size)
-                {
-                    /* FILE END*/
-                    player.state = PLAYER_STATE_STOPED;
                 }
                 break;
             }
             case PLAYER_EVENT_PAUSE:
             {
+                mp3_pcm_output_pause(player.pcm, RT_TRUE);
                 /* wait resume or stop event forever */
                 event = mp3_player_event_handler(&player, RT_WAITING_FOREVER);
+                if (player.state == PLAYER_STATE_PLAYING)
+                    mp3_pcm_output_pause(player.pcm, RT_FALSE);
             }
 
             default:
                 break;
             }
+            if (eof)
+            {
+#ifdef MP3_PLAYER_USING_GAPLESS
+                /* splice the queued track while the pcm ring still plays this one */
+                if (mp3_player_track_next(&player) == RT_EOK)
+                    continue;
+#endif
+                /* FILE END*/
+                mp3_pcm_output_drain(player.pcm);
+                next_uri = mp3_player_queue_pop(&player);
+                if (next_uri == RT_NULL)
+                    player.state = PLAYER_STATE_STOPED;
+                break;
+            }
             if (player.state == PLAYER_STATE_STOPED)
             {
                 break;
@@ -641,17 +1900,14 @@ static void mp3_player_entry(void *parameter)
     }
 
 __exit:
-    if (player.in_buffer)
+    if (player.mp3_decoder)
     {
-        rt_free(player.in_buffer);
-        player.in_buffer = RT_NULL;
+        MP3FreeDecoder(player.mp3_decoder);
+        player.mp3_decoder = 0;
     }
 
-    if (player.out_buffer)
-    {
-        rt_free(player.out_buffer);
-        player.out_buffer = RT_NULL;
-    }
+    mp3_input_deinit(player.input);
+    player.in_buffer = RT_NULL;
 
     if (player.mq)
     {
@@ -7,6 +7,10 @@
  */
 
 #include "mp3_player.h"
+#include "mp3_id3v2.h"
+#ifdef MP3_PLAYER_USING_LIBRARY
+#include "mp3_library.h"
+#endif
 
 #include <rtthread.h>
 #include <rtdevice.h>
@@ -14,6 +18,7 @@
 #include <mp3_player.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 enum MP3_PLAYER_ACTTION
 {
@@ -24,7 +29,12 @@ enum MP3_PLAYER_ACTTION
     MP3_PLAYER_ACTION_RESUME = 4,
     MP3_PLAYER_ACTION_VOLUME = 5,
     MP3_PLAYER_ACTION_DUMP = 6,
-    MP3_PLAYER_ACTION_JUMP = 7
+    MP3_PLAYER_ACTION_JUMP = 7,
+    MP3_PLAYER_ACTION_NEXT = 8,
+    MP3_PLAYER_ACTION_ART = 9,
+    MP3_PLAYER_ACTION_LIBRARY = 10,
+    MP3_PLAYER_ACTION_BENCH = 11,
+    MP3_PLAYER_ACTION_STATS = 12
 };
 
 struct mp3_play_args
@@ -33,6 +43,7 @@ struct mp3_play_args
     char *uri;
     int volume;
     int seconds;
+    int reset;
 };
 
 static const char *state_str[] =
@@ -52,6 +63,15 @@ static struct optparse_long opts[] =
         {"volume", 'v', OPTPARSE_REQUIRED},
         {"dump", 'd', OPTPARSE_NONE},
         {"jump", 'j', OPTPARSE_REQUIRED},
+        {"next", 'n', OPTPARSE_REQUIRED},
+        {"art", 'a', OPTPARSE_REQUIRED},
+        {"bench", 'b', OPTPARSE_REQUIRED},
+#ifdef MP3_PLAYER_USING_LIBRARY
+        {"library", 'l', OPTPARSE_REQUIRED},
+#endif
+#ifdef MP3_PLAYER_USING_STATS
+        {"stats", 'S', OPTPARSE_OPTIONAL},
+#endif
         {NULL, 0, OPTPARSE_NONE}};
 
 static void usage(void)
@@ -66,18 +86,171 @@ static void usage(void)
     rt_kprintf("  -v lvl, --volume=lvl               Change the volume(0~99).\n");
     rt_kprintf("  -d,     --dump                     Dump play relevant information.\n");
     rt_kprintf("  -j,     --jump                     Jump to seconds that given.\n");
+    rt_kprintf("  -n URI, --next=URI                 Queue mp3 music played after the current one.\n");
+    rt_kprintf("  -a URI, --art=URI                  Save album art of the playing music to URI.\n");
+    rt_kprintf("  -b URI, --bench=URI                Decode URI as fast as possible without playing it.\n");
+#ifdef MP3_PLAYER_USING_LIBRARY
+    rt_kprintf("  -l DIR, --library=DIR              Scan mp3 music under DIR in background.\n");
+#endif
+#ifdef MP3_PLAYER_USING_STATS
+    rt_kprintf("  -S,     --stats[=reset]            Print playback statistics, reset clears them after.\n");
+#endif
 }
 
 static void dump_status(void)
 {
+    uint32_t level, stalls, resyncs, resync_bytes;
+#ifdef MP3_PLAYER_USING_LIBRARY
+    struct mp3_library_progress progress;
+    static const char *library_state_str[] = {"IDLE", "SCANNING", "DONE", "FAILED"};
+#endif
+
     rt_kprintf("\nmp3_player status:\n");
     rt_kprintf("uri     - %s\n", mp3_player_uri_get());
     rt_kprintf("status  - %s\n", state_str[mp3_player_state_get()]);
     rt_kprintf("volume  - %d\n", mp3_player_volume_get());
+    mp3_player_readahead_get(&level, &stalls);
+    rt_kprintf("input   - %d%%, %d stalls\n", level, stalls);
+    rt_kprintf("startup - %d ms to first sample\n", mp3_player_first_sample_ms());
+    mp3_player_resync_get(&resyncs, &resync_bytes);
+    rt_kprintf("resync  - %d times, %d bytes skipped\n", resyncs, resync_bytes);
+#ifdef MP3_PLAYER_USING_LIBRARY
+    mp3_library_progress_get(&progress);
+    rt_kprintf("library - %s, %d tracks, %d probed, %d cached, %d/%d dirs unchanged, %d pauses\n",
+               library_state_str[progress.state], progress.tracks, progress.files, progress.cached,
+               progress.dirs_skipped, progress.dirs + progress.dirs_skipped, progress.pauses);
+#endif
     mp3_disp_time();
     mp3_info_show();
 }
 
+#define ART_CHUNK_SIZE (512)
+
+static rt_err_t save_art_chunk(const uint8_t *data, uint32_t size, void *user)
+{
+    return fwrite(data, 1, size, (FILE *)user) == size ? RT_EOK : RT_ERROR;
+}
+
+static void save_art(char *uri)
+{
+    mp3_picture_t picture;
+    uint8_t *buf;
+    FILE *fp;
+    int i;
+
+    /* prefer the front cover */
+    if (mp3_player_picture_get(0, &picture) != RT_EOK)
+    {
+        rt_kprintf("no album art.\n");
+        return;
+    }
+    for (i = 1; picture.type != 3 && mp3_player_picture_get(i, &picture) == RT_EOK; i++)
+        ;
+    if (picture.type != 3)
+        mp3_player_picture_get(0, &picture);
+
+    buf = rt_malloc(ART_CHUNK_SIZE);
+    fp = fopen(uri, "wb");
+    if (buf == RT_NULL || fp == RT_NULL)
+    {
+        rt_kprintf("can not save album art to %s.\n", uri);
+    }
+    else if (mp3_picture_stream(mp3_player_uri_get(), &picture, buf, ART_CHUNK_SIZE, save_art_chunk, fp) == RT_EOK)
+    {
+        rt_kprintf("%s, %d bytes saved to %s.\n", picture.mime, picture.length, uri);
+    }
+    if (fp)
+        fclose(fp);
+    if (buf)
+        rt_free(buf);
+}
+
+static void bench_file(char *uri)
+{
+    struct mp3_bench bench;
+    rt_tick_t ticks;
+    uint32_t speed;
+    rt_err_t result;
+
+    result = mp3_player_bench(uri, &bench);
+    if (result == -RT_EBUSY)
+    {
+        rt_kprintf("stop the player before the bench.\n");
+        return;
+    }
+    if (result != RT_EOK)
+    {
+        rt_kprintf("bench %s failed.\n", uri);
+        return;
+    }
+
+    /* a run shorter than a tick is counted as one */
+    ticks = bench.ticks ? bench.ticks : 1;
+    /* tenths of real time */
+    speed = (uint64_t)bench.samples * RT_TICK_PER_SECOND * 10 / ((uint64_t)bench.samplerate * ticks);
+
+    rt_kprintf("\nmp3_player bench:\n");
+    rt_kprintf("uri     - %s\n", uri);
+    rt_kprintf("frames  - %d decoded in %d ms, %d errors, %d resyncs\n", bench.frames,
+               ticks * 1000 / RT_TICK_PER_SECOND, bench.errors, bench.resyncs);
+    rt_kprintf("speed   - %d frames/s, %d.%dx real time\n",
+               (uint32_t)((uint64_t)bench.frames * RT_TICK_PER_SECOND / ticks), speed / 10, speed % 10);
+    rt_kprintf("frame   - min %d, avg %d, max %d %s\n", bench.frame_min,
+               (uint32_t)(bench.frame_total / bench.frames), bench.frame_max, bench.cycles ? "cycles" : "ticks");
+    rt_kprintf("heap    - peak raised %d bytes by the run, %d bytes peak since boot\n", bench.heap_grown,
+               bench.heap_peak);
+    rt_kprintf("stack   - %d/%d bytes used\n", bench.stack_used, bench.stack_size);
+}
+
+#ifdef MP3_PLAYER_USING_STATS
+static void stats_time_show(const char *name, const struct mp3_stats_time *time, const char *unit)
+{
+    uint32_t i;
+
+    rt_kprintf("%s - %d times, avg %d, max %d %s\n", name, time->count,
+               time->count ? (uint32_t)(time->total / time->count) : 0, time->max, unit);
+    for (i = 0; i < MP3_STATS_HIST_BUCKETS; i++)
+    {
+        if (time->hist[i] == 0)
+            continue;
+        if (i == 0)
+            rt_kprintf("          %10d          : %d\n", 0, time->hist[i]);
+        else if (i == MP3_STATS_HIST_BUCKETS - 1)
+            rt_kprintf("          %10d ~        : %d\n", (uint32_t)1 << (i - 1), time->hist[i]);
+        else
+            rt_kprintf("          %10d ~ %-10d: %d\n", (uint32_t)1 << (i - 1), ((uint32_t)1 << i) - 1, time->hist[i]);
+    }
+}
+
+static void stats_level_show(const char *name, const struct mp3_stats_level *level)
+{
+    rt_kprintf("%s - min %d%%, avg %d%%\n", name, level->min,
+               level->count ? (uint32_t)(level->total / level->count) : 0);
+}
+
+static void stats_show(int reset)
+{
+    struct mp3_player_stats stats;
+    const char *unit;
+
+    mp3_player_stats_get(&stats);
+    if (reset)
+        mp3_player_stats_reset();
+    unit = stats.cycles ? "cycles" : "ticks";
+
+    rt_kprintf("\nmp3_player stats:\n");
+    rt_kprintf("frames  - %d decoded, %d underruns, %d resyncs\n", stats.frames, stats.underruns, stats.resyncs);
+    rt_kprintf("read    - %d KB\n", (uint32_t)(stats.bytes_read / 1024));
+    stats_level_show("input  ", &stats.input);
+    stats_level_show("pcm    ", &stats.pcm);
+    stats_time_show("decode ", &stats.decode, unit);
+    stats_time_show("write  ", &stats.write, unit);
+    stats_time_show("fread  ", &stats.read, unit);
+    if (reset)
+        rt_kprintf("stats cleared.\n");
+}
+#endif
+
 int mp3_play_args_prase(int argc, char *argv[], struct mp3_play_args *play_args)
 {
     int ch;
@@ -138,6 +311,40 @@ int mp3_play_args_prase(int argc, char *argv[], struct mp3_play_args *play_args)
             play_args->seconds = (options.optarg == RT_NULL) ? (-1) : atoi(options.optarg);
             break;
 
+        case 'n':
+            play_args->action = MP3_PLAYER_ACTION_NEXT;
+            play_args->uri = options.optarg;
+            break;
+
+        case 'a':
+            play_args->action = MP3_PLAYER_ACTION_ART;
+            play_args->uri = options.optarg;
+            break;
+
+        case 'b':
+            play_args->action = MP3_PLAYER_ACTION_BENCH;
+            play_args->uri = options.optarg;
+            break;
+
+#ifdef MP3_PLAYER_USING_LIBRARY
+        case 'l':
+            play_args->action = MP3_PLAYER_ACTION_LIBRARY;
+            play_args->uri = options.optarg;
+            break;
+#endif
+
+#ifdef MP3_PLAYER_USING_STATS
+        case 'S':
+            play_args->action = MP3_PLAYER_ACTION_STATS;
+            if (options.optarg != RT_NULL)
+            {
+                if (strcmp(options.optarg, "reset") != 0)
+                    result = -RT_EINVAL;
+                play_args->reset = 1;
+            }
+            break;
+#endif
+
         default:
             result = -RT_EINVAL;
             break;
@@ -198,6 +405,30 @@ int mp3_player(int argc, char *argv[])
     case MP3_PLAYER_ACTION_JUMP:
         mp3_seek(play_args.seconds);
         break;
+
+    case MP3_PLAYER_ACTION_NEXT:
+        mp3_player_queue_next(play_args.uri);
+        break;
+
+    case MP3_PLAYER_ACTION_ART:
+        save_art(play_args.uri);
+        break;
+
+    case MP3_PLAYER_ACTION_BENCH:
+        bench_file(play_args.uri);
+        break;
+
+#ifdef MP3_PLAYER_USING_LIBRARY
+    case MP3_PLAYER_ACTION_LIBRARY:
+        if (mp3_library_scan(play_args.uri) == -RT_EBUSY)
+            rt_kprintf("library scan is running.\n");
+        break;
+#endif
+#ifdef MP3_PLAYER_USING_STATS
+    case MP3_PLAYER_ACTION_STATS:
+        stats_show(play_args.reset);
+        break;
+#endif
     default:
         result = -RT_ERROR;
         break;
@@ -0,0 +1,208 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_readahead.h"
+#include "mp3_stats.h"
+#include <string.h>
+
+#define LOG_TAG "mp3 readahead"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+#define MP3_READAHEAD_THREAD_STACK_SIZE (1024 * 2)
+#define MP3_READAHEAD_THREAD_PRIORITY (16) /* below the decoder thread */
+
+#define RA_EVENT_WAKE (1 << 0)    /* decoder -> reader: started or a block was freed */
+#define RA_EVENT_DATA (1 << 1)    /* reader -> decoder: a block was read */
+#define RA_EVENT_STOPPED (1 << 2) /* reader -> decoder: reader is idle */
+
+/**
+ * @description: read file into free space of the input ring
+ * @param {struct mp3_readahead} *ra
+ * @param {rt_bool_t} one_block stop at the next block boundary
+ * @return the error code,RT_ERROR if ring is full or at end of file
+ */
+static rt_err_t mp3_readahead_read(struct mp3_readahead *ra, rt_bool_t one_block)
+{
+    struct mp3_input *input = ra->input;
+    uint8_t *ptr;
+    uint32_t len, pos, size;
+
+    if (input->eof)
+        return RT_ERROR;
+    ptr = mp3_input_write_ptr(input, &len);
+    if (ptr == RT_NULL)
+        return RT_ERROR;
+
+    if (one_block)
+    {
+        pos = ptr - input->buffer;
+        if (len > input->block_size - (pos & (input->block_size - 1)))
+            len = input->block_size - (pos & (input->block_size - 1));
+    }
+
+    MP3_STATS_TIME(read, size = mp3_file_read(ra->fp, ptr, len));
+    MP3_STATS_ADD(bytes_read, size);
+    ra->reads++;
+    ra->bytes += size;
+    if (size > 0)
+        mp3_input_produce(input, size);
+    if (size < len)
+        input->eof = 1;
+
+    return RT_EOK;
+}
+
+#ifdef MP3_PLAYER_USING_READAHEAD
+/**
+ * @description: read-ahead thread
+ * @param {void *}parameter
+ * @return None
+ */
+static void mp3_readahead_entry(void *parameter)
+{
+    struct mp3_readahead *ra = (struct mp3_readahead *)parameter;
+
+    while (1)
+    {
+        rt_event_recv(ra->event, RA_EVENT_WAKE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, RT_NULL);
+
+        while (ra->running)
+        {
+            if (mp3_readahead_read(ra, RT_TRUE) != RT_EOK)
+            {
+                /* full or end of file, sleep until the decoder frees a block */
+                ra->waiting = 1;
+                break;
+            }
+            rt_event_send(ra->event, RA_EVENT_DATA);
+        }
+        if (!ra->running)
+            rt_event_send(ra->event, RA_EVENT_STOPPED);
+    }
+}
+#endif
+
+/**
+ * @description: init read-ahead,starts the read-ahead thread if enabled
+ * @param {struct mp3_readahead} *ra
+ * @param {struct mp3_input} *input ring to fill
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_readahead_init(struct mp3_readahead *ra, struct mp3_input *input)
+{
+    memset(ra, 0, sizeof(struct mp3_readahead));
+    ra->input = input;
+    ra->fp = MP3_FILE_NULL;
+
+#ifdef MP3_PLAYER_USING_READAHEAD
+    ra->event = rt_event_create("mp3_ra", RT_IPC_FLAG_FIFO);
+    if (ra->event == RT_NULL)
+        return -RT_ENOMEM;
+
+    ra->tid = rt_thread_create("mp3_ra",
+                               mp3_readahead_entry,
+                               ra,
+                               MP3_READAHEAD_THREAD_STACK_SIZE,
+                               MP3_READAHEAD_THREAD_PRIORITY, 10);
+    if (ra->tid == RT_NULL)
+    {
+        LOG_E("can not create read-ahead thread.");
+        rt_event_delete(ra->event);
+        ra->event = RT_NULL;
+        return -RT_ERROR;
+    }
+    rt_thread_startup(ra->tid);
+#endif
+
+    return RT_EOK;
+}
+
+/**
+ * @description: start reading a file from an offset,buffered data is dropped
+ * @param {struct mp3_readahead} *ra
+ * @param {mp3_file_t} fp positioned at offset
+ * @param {uint32_t} offset
+ * @return None
+ */
+void mp3_readahead_start(struct mp3_readahead *ra, mp3_file_t fp, uint32_t offset)
+{
+    ra->fp = fp;
+    mp3_input_reset(ra->input, offset);
+    ra->running = 1;
+#ifdef MP3_PLAYER_USING_READAHEAD
+    ra->waiting = 0;
+    rt_event_send(ra->event, RA_EVENT_WAKE);
+#endif
+}
+
+/**
+ * @description: stop reading,the file may be used by the caller after return
+ * @param {struct mp3_readahead} *ra
+ * @return None
+ */
+void mp3_readahead_stop(struct mp3_readahead *ra)
+{
+    if (!ra->running)
+        return;
+
+    ra->running = 0;
+#ifdef MP3_PLAYER_USING_READAHEAD
+    /* wait for the read in progress */
+    rt_event_recv(ra->event, RA_EVENT_STOPPED, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_NO, RT_NULL);
+    rt_event_send(ra->event, RA_EVENT_WAKE);
+    rt_event_recv(ra->event, RA_EVENT_STOPPED, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, RT_NULL);
+#endif
+    ra->fp = MP3_FILE_NULL;
+}
+
+/**
+ * @description: make sure some bytes are buffered,called by the decoder
+ * @param {struct mp3_readahead} *ra
+ * @param {uint32_t} need bytes wanted
+ * @param {rt_int32_t} timeout ticks to wait for the read-ahead thread
+ * @return the error code,0 if need bytes are buffered or input reached end of file
+ */
+rt_err_t mp3_readahead_fill(struct mp3_readahead *ra, uint32_t need, rt_int32_t timeout)
+{
+    struct mp3_input *input = ra->input;
+
+#ifdef MP3_PLAYER_USING_READAHEAD
+    if (ra->waiting && input->size - mp3_input_used(input) >= input->block_size)
+    {
+        ra->waiting = 0;
+        rt_event_send(ra->event, RA_EVENT_WAKE);
+    }
+    if (mp3_input_used(input) >= need || input->eof)
+        return RT_EOK;
+
+    /* read-ahead fell behind */
+    ra->stalls++;
+    rt_event_recv(ra->event, RA_EVENT_DATA, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, timeout, RT_NULL);
+    if (mp3_input_used(input) >= need || input->eof)
+        return RT_EOK;
+    return -RT_ETIMEOUT;
+#else
+    /* read in the decoder thread, large reads once the input runs low */
+    if (mp3_input_used(input) < need)
+    {
+        while (mp3_readahead_read(ra, RT_FALSE) == RT_EOK)
+            ;
+    }
+    return RT_EOK;
+#endif
+}
+
+/**
+ * @description: get input fill level
+ * @param {struct mp3_readahead} *ra
+ * @return percent of the input ring filled
+ */
+uint32_t mp3_readahead_level(struct mp3_readahead *ra)
+{
+    return mp3_input_used(ra->input) * 100 / ra->input->size;
+}
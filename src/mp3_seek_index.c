@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_seek_index.h"
+#include "mp3_frame.h"
+#include <string.h>
+
+#define LOG_TAG "mp3 index"
+#define LOG_LVL DBG_INFO
+#include <ulog.h>
+
+/**
+ * @description: init seek index
+ * @param {struct mp3_seek_index} *index
+ * @param {uint32_t} capacity max entries
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek_index_init(struct mp3_seek_index *index, uint32_t capacity)
+{
+    memset(index, 0, sizeof(struct mp3_seek_index));
+    /* even capacity keeps decimation simple */
+    capacity &= ~1U;
+    if (capacity < 2)
+        return -RT_EINVAL;
+
+    index->offset = rt_malloc(capacity * sizeof(uint32_t));
+    if (index->offset == RT_NULL)
+    {
+        LOG_E("can not malloc seek index.");
+        return -RT_ENOMEM;
+    }
+    index->capacity = capacity;
+    mp3_seek_index_reset(index);
+
+    return rt_mutex_init(&index->lock, "mp3_idx", RT_IPC_FLAG_FIFO);
+}
+
+/**
+ * @description: forget all entries
+ * @param {struct mp3_seek_index} *index
+ * @return None
+ */
+void mp3_seek_index_reset(struct mp3_seek_index *index)
+{
+    index->ready = 0;
+    index->frames = 0;
+    index->count = 0;
+    index->stride = 1;
+    index->total_samples = 0;
+    index->samplerate = 0;
+    index->samples = 0;
+    index->vbr = 0;
+}
+
+/**
+ * @description: record one frame,headers are filtered like mp3_info_exact so both count the same frames
+ */
+static rt_err_t mp3_seek_index_walk_cb(void *user, uint32_t walked, uint32_t offset, const mp3_frame_header_t *header)
+{
+    struct mp3_seek_index *index = (struct mp3_seek_index *)user;
+    uint32_t frame = index->frames;
+    uint32_t i;
+
+    if (frame == 0)
+    {
+        index->first = *header;
+        index->samplerate = header->samplerate;
+        index->samples = header->samples;
+    }
+    else if (!mp3_frame_header_match(&index->first, header))
+    {
+        return RT_EOK; /* false sync in damaged data,not counted */
+    }
+    else if (header->bitrate != index->first.bitrate)
+    {
+        index->vbr = 1;
+    }
+    index->total_samples += header->samples;
+    index->frames = frame + 1;
+
+    if (frame % index->stride)
+        return RT_EOK;
+
+    rt_mutex_take(&index->lock, RT_WAITING_FOREVER);
+    if (index->count == index->capacity)
+    {
+        /* full, keep every other entry and double the stride */
+        for (i = 0; i < index->capacity / 2; i++)
+            index->offset[i] = index->offset[i * 2];
+        index->count = index->capacity / 2;
+        index->stride *= 2;
+    }
+    if (frame % index->stride == 0)
+    {
+        index->offset[index->count] = offset;
+        index->count++;
+    }
+    rt_mutex_release(&index->lock);
+
+    return RT_EOK;
+}
+
+/**
+ * @description: build seek index by walking frame headers
+ * @param {struct mp3_seek_index} *index
+ * @param {mp3_file_t} fp file used only by the caller
+ * @param {uint32_t} data_start file offset of the first frame
+ * @param {uint32_t} data_end file offset where audio data ends
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size
+ * @param {volatile rt_uint8_t} *cancel build stops when it becomes non-zero
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_seek_index_build(struct mp3_seek_index *index, mp3_file_t fp, uint32_t data_start, uint32_t data_end,
+                              uint8_t *buf, uint32_t size, volatile rt_uint8_t *cancel)
+{
+#if (LOG_LVL >= DBG_LOG)
+    rt_tick_t tick = rt_tick_get();
+#endif
+
+    mp3_seek_index_reset(index);
+    mp3_frame_walk(fp, data_start, data_end, buf, size, mp3_seek_index_walk_cb, index, cancel);
+    if (cancel && *cancel)
+        return -RT_EINTR;
+
+    index->ready = 1;
+#if (LOG_LVL >= DBG_LOG)
+    LOG_D("indexed %d frames, stride %d, %d ms", index->frames, index->stride,
+          (rt_tick_get() - tick) * 1000 / RT_TICK_PER_SECOND);
+#endif
+
+    return RT_EOK;
+}
+
+/**
+ * @description: find the nearest indexed frame at or before a frame,
+ *               safe to call while the index is being built
+ * @param {struct mp3_seek_index} *index
+ * @param {uint32_t} frame
+ * @param {uint32_t} *entry_frame indexed frame number
+ * @param {uint32_t} *offset file offset of the indexed frame
+ * @return the error code,0 on success,RT_ERROR if frame is not indexed yet
+ */
+rt_err_t mp3_seek_index_lookup(struct mp3_seek_index *index, uint32_t frame, uint32_t *entry_frame, uint32_t *offset)
+{
+    uint32_t entry;
+    rt_err_t ret = RT_ERROR;
+
+    if (index->offset == RT_NULL)
+        return RT_ERROR;
+
+    rt_mutex_take(&index->lock, RT_WAITING_FOREVER);
+    entry = frame / index->stride;
+    /* only frames inside the walked range land exactly */
+    if (entry < index->count && (index->ready || frame < index->frames))
+    {
+        *offset = index->offset[entry];
+        *entry_frame = entry * index->stride;
+        ret = RT_EOK;
+    }
+    rt_mutex_release(&index->lock);
+
+    return ret;
+}
@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-17     MrzhangF1ghter    first implementation
+ */
+
+#include "mp3_stats.h"
+#include <string.h>
+
+/* DWT cycle counter of Cortex-M3/M4/M7/M33 */
+#if defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7) || defined(ARCH_ARM_CORTEX_M33)
+#define MP3_STATS_USING_DWT
+#define DEM_CR (*(volatile rt_uint32_t *)0xE000EDFC)
+#define DWT_CTRL (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CYCCNT (*(volatile rt_uint32_t *)0xE0001004)
+#define DWT_LAR (*(volatile rt_uint32_t *)0xE0001FB0)
+#define DEM_CR_TRCENA (1UL << 24)
+#define DWT_CTRL_CYCCNTENA (1UL << 0)
+#define DWT_CTRL_NOCYCCNT (1UL << 25)
+#define DWT_LAR_KEY (0xC5ACCE55)
+#endif
+
+static rt_uint8_t clock_cycles;
+
+#ifdef MP3_PLAYER_USING_STATS
+struct mp3_player_stats mp3_stats;
+#endif
+
+/**
+ * @description: start the DWT cycle counter if the cpu has one
+ * @param None
+ * @return RT_TRUE if mp3_stats_clock counts cpu cycles,else it counts ticks
+ */
+rt_bool_t mp3_stats_clock_init(void)
+{
+#ifdef MP3_STATS_USING_DWT
+    if (!clock_cycles)
+    {
+        DEM_CR |= DEM_CR_TRCENA;
+        if (DWT_CTRL & DWT_CTRL_NOCYCCNT)
+            return RT_FALSE;
+        DWT_LAR = DWT_LAR_KEY; /* locked on Cortex-M7 */
+        DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+        clock_cycles = DWT_CYCCNT != DWT_CYCCNT;
+    }
+#endif
+    return clock_cycles;
+}
+
+/**
+ * @description: read the clock of times,wraps around
+ * @param None
+ * @return cpu cycles or ticks
+ */
+rt_uint32_t mp3_stats_clock(void)
+{
+#ifdef MP3_STATS_USING_DWT
+    if (clock_cycles)
+        return DWT_CYCCNT;
+#endif
+    return rt_tick_get();
+}
+
+/**
+ * @description: add a time to a histogram
+ * @param {struct mp3_stats_time} *time
+ * @param {rt_uint32_t} value
+ * @return None
+ */
+void mp3_stats_time_add(struct mp3_stats_time *time, rt_uint32_t value)
+{
+    uint32_t bucket = 0;
+
+    while (bucket < MP3_STATS_HIST_BUCKETS - 1 && (value >> bucket) != 0)
+        bucket++;
+    time->hist[bucket]++;
+    if (value > time->max)
+        time->max = value;
+    time->total += value;
+    time->count++;
+}
+
+/**
+ * @description: add a fill level
+ * @param {struct mp3_stats_level} *level
+ * @param {uint32_t} percent
+ * @return None
+ */
+void mp3_stats_level_add(struct mp3_stats_level *level, uint32_t percent)
+{
+    if (level->count == 0 || percent < level->min)
+        level->min = percent;
+    level->total += percent;
+    level->count++;
+}
+
+/**
+ * @description: get playback statistics
+ * @param {struct mp3_player_stats} *stats
+ * @return the error code,0 on success,-RT_ENOSYS without MP3_PLAYER_USING_STATS
+ */
+rt_err_t mp3_player_stats_get(struct mp3_player_stats *stats)
+{
+#ifdef MP3_PLAYER_USING_STATS
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    memcpy(stats, &mp3_stats, sizeof(struct mp3_player_stats));
+    rt_hw_interrupt_enable(level);
+    stats->cycles = clock_cycles;
+
+    return RT_EOK;
+#else
+    memset(stats, 0, sizeof(struct mp3_player_stats));
+    return -RT_ENOSYS;
+#endif
+}
+
+/**
+ * @description: clear playback statistics
+ * @param None
+ * @return None
+ */
+void mp3_player_stats_reset(void)
+{
+#ifdef MP3_PLAYER_USING_STATS
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    memset(&mp3_stats, 0, sizeof(struct mp3_player_stats));
+    rt_hw_interrupt_enable(level);
+#endif
+}
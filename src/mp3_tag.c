@@ -7,6 +7,8 @@
  */
 
 #include "mp3_tag.h"
+#include "mp3_frame.h"
+#include "mp3_id3v2.h"
 #include <rtthread.h>
 #include <string.h>
 #include <stdio.h>
@@ -202,14 +204,25 @@ void mp3_id3v1_tag_print(ID3V1_Tag_t id3v1_tag)
  */
 rt_err_t mp3_info_print(mp3_info_t mp3_info)
 {
+    mp3_basic_info_t *basic_info = &mp3_info.mp3_basic_info;
+    uint32_t i;
+
     rt_kprintf("------------MP3 INFO------------\r\n");
-    rt_kprintf("Title:%s\r\n", mp3_info.mp3_basic_info.title);
-    rt_kprintf("Artist:%s\r\n", mp3_info.mp3_basic_info.artist);
-    rt_kprintf("Year:%s\r\n", mp3_info.mp3_basic_info.year);
-    rt_kprintf("Comment:%s\r\n", mp3_info.mp3_basic_info.comment);
-    rt_kprintf("Genre:%s\r\n", mp3_get_genre_string_by_id(mp3_info.mp3_basic_info.genre));
+    rt_kprintf("Title:%.30s\r\n", basic_info->title);
+    rt_kprintf("Artist:%.30s\r\n", basic_info->artist);
+    rt_kprintf("Album:%s\r\n", basic_info->album);
+    rt_kprintf("Track:%s\r\n", basic_info->track);
+    rt_kprintf("Year:%.4s\r\n", basic_info->year);
+    rt_kprintf("Comment:%.30s\r\n", basic_info->comment);
+    rt_kprintf("Genre:%s\r\n", basic_info->genre_text[0] ? (char *)basic_info->genre_text : mp3_get_genre_string_by_id(basic_info->genre));
+    for (i = 0; i < basic_info->txxx_count; i++)
+        rt_kprintf("%s:%s\r\n", basic_info->txxx[i].desc, basic_info->txxx[i].value);
+    for (i = 0; i < basic_info->picture_count; i++)
+        rt_kprintf("Picture:type %d,%s,%d bytes\r\n", basic_info->picture[i].type, basic_info->picture[i].mime, basic_info->picture[i].length);
     rt_kprintf("Length:%02d:%02d\r\n", mp3_info.total_seconds / 60, mp3_info.total_seconds % 60);
     rt_kprintf("Bitrate:%d kbit/s\r\n", mp3_info.bitrate / 1000);
+    if (mp3_info.total_frames)
+        rt_kprintf("Frames:%d,%d samples%s\r\n", mp3_info.total_frames, mp3_info.total_samples, mp3_info.exact ? ",counted" : "");
     rt_kprintf("Frequency:%d Hz\r\n", mp3_info.samplerate);
     rt_kprintf("--------------------------------\r\n");
 	return RT_EOK;
@@ -221,22 +234,22 @@ rt_err_t mp3_info_print(mp3_info_t mp3_info)
  * @param {ID3V1_Tag_t} *id3v1_tag
  * @return the error code,0 on success
  */
-static rt_err_t mp3_id3v1_tag_decode(FILE *fp, uint8_t *buf, mp3_basic_info_t *basic_info)
+static rt_err_t mp3_id3v1_tag_decode(mp3_file_t fp, uint8_t *buf, mp3_basic_info_t *basic_info)
 {
     ID3V1_Tag_t *tag;
     long int file_pos;
     //int read_size;
     rt_err_t ret;
 
-    if (fp == RT_NULL || buf == RT_NULL)
+    if (fp == MP3_FILE_NULL || buf == RT_NULL)
     {
         return RT_ERROR;
     }
 
-    file_pos = ftell(fp); /* save current file positon */
+    file_pos = mp3_file_tell(fp); /* save current file positon */
 
-    fseek(fp, -128, SEEK_END);       /* move read pointer to id3v1 position */
-    if (fread(buf, 1, 128, fp) <= 0) /* read 128 bytes */
+    mp3_file_seek(fp, -128, SEEK_END);      /* move read pointer to id3v1 position */
+    if (mp3_file_read(fp, buf, 128) != 128) /* read 128 bytes */
     {
         ret = RT_ERROR;
         goto __exit;
@@ -264,303 +277,438 @@ static rt_err_t mp3_id3v1_tag_decode(FILE *fp, uint8_t *buf, mp3_basic_info_t *b
     }
 
 __exit:
-    fseek(fp, file_pos, SEEK_SET); /* resume file positon */
+    mp3_file_seek(fp, file_pos, SEEK_SET); /* resume file positon */
     return ret;
 }
 
+#define MP3_BE16(p) (((uint16_t)(p)[0] << 8) | (p)[1])
+#define MP3_BE32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (p)[3])
+
 /**
- * @description: read id3v2 text
- * @param {FILE} *fp
- * @param {uint32_t} data_len
- * @param {char} *buff
- * @param {uint32_t} buff_size
- * @return the error code,0 on success
- * @verbatim  Taken from http://www.mikrocontroller.net/topic/252319
+ * @description: decode Xing/Info frame and the LAME tag following it
+ * @param {MP3_FrameXing_t} *fxing
+ * @param {uint32_t} size bytes available from fxing
+ * @param {mp3_info_t} *mp3_info
+ * @return None
+ */
+static void mp3_xing_decode(MP3_FrameXing_t *fxing, uint32_t size, mp3_info_t *mp3_info)
+{
+    uint8_t flags = fxing->flags[3];
+    uint8_t *p = fxing->frames; /* optional fields start here */
+    uint8_t *end = (uint8_t *)fxing + size;
+
+    if (flags & XING_FLAG_FRAMES)
+    {
+        mp3_info->total_frames = MP3_BE32(p);
+        p += 4;
+    }
+    if (flags & XING_FLAG_BYTES)
+    {
+        mp3_info->vbr_bytes = MP3_BE32(p);
+        p += 4;
+    }
+    if (flags & XING_FLAG_TOC)
+    {
+        memcpy(mp3_info->toc, p, MP3_TOC_SIZE);
+        mp3_info->toc_valid = 1;
+        p += MP3_TOC_SIZE;
+    }
+    if (flags & XING_FLAG_QUALITY)
+        p += 4;
+
+    /* LAME tag, encoder delay and padding are two 12 bit values at offset 21 */
+    if (p + LAME_TAG_DELAY_OFFSET + 3 <= end &&
+        (strncmp("LAME", (char *)p, 4) == 0 || strncmp("Lavc", (char *)p, 4) == 0 || strncmp("Lavf", (char *)p, 4) == 0))
+    {
+        p += LAME_TAG_DELAY_OFFSET;
+        mp3_info->enc_delay = (p[0] << 4) | (p[1] >> 4);
+        mp3_info->enc_padding = ((p[1] & 0x0F) << 8) | p[2];
+        mp3_info->gapless = 1;
+    }
+}
+
+/**
+ * @description: decode VBRI frame,the seek table is converted to a Xing style toc
+ * @param {MP3_FrameVBRI_t} *fvbri
+ * @param {uint32_t} size bytes available from fvbri
+ * @param {mp3_info_t} *mp3_info
+ * @return None
  */
-static uint8_t mp3_read_id3v2_text(FILE *fp, uint32_t data_len, uint8_t *buff, uint32_t buff_size)
+static void mp3_vbri_decode(MP3_FrameVBRI_t *fvbri, uint32_t size, mp3_info_t *mp3_info)
 {
-    uint8_t byEncoding = 0;
-    if (fread(&byEncoding, 1, 1, fp) == 1)
+    uint16_t entries, scale, entry_size, entry_frames;
+    uint8_t *table = (uint8_t *)(fvbri + 1);
+    uint32_t entry = 0, entry_bytes = 0, bytes = 0; /* bytes before current entry */
+    uint32_t frame, i, j;
+    uint64_t pos;
+
+    mp3_info->total_frames = MP3_BE32(fvbri->frames);
+    mp3_info->vbr_bytes = MP3_BE32(fvbri->fsize);
+
+    entries = MP3_BE16(fvbri->toc_entries);
+    scale = MP3_BE16(fvbri->toc_scale);
+    entry_size = MP3_BE16(fvbri->toc_entry_size);
+    entry_frames = MP3_BE16(fvbri->toc_entry_frames);
+    if (entries == 0 || entry_size == 0 || entry_size > 4 || entry_frames == 0 ||
+        mp3_info->total_frames == 0 || mp3_info->vbr_bytes == 0 ||
+        sizeof(MP3_FrameVBRI_t) + (uint32_t)entries * entry_size > size)
+        return;
+
+    for (i = 0; i < MP3_TOC_SIZE; i++)
     {
-        data_len--;
-        if (data_len <= (buff_size - 1))
+        frame = (uint64_t)i * mp3_info->total_frames / MP3_TOC_SIZE;
+        /* advance to the table entry holding this frame */
+        while (entry < entries && frame >= (entry + 1) * entry_frames)
         {
-            if ((fread(buff, 1, data_len, fp) == data_len))
-            {
-                if (byEncoding == 0)
-                {
-                    // ISO-8859-1 multibyte
-                    // just add a terminating zero
-                    buff[data_len] = 0;
-                }
-                else if (byEncoding == 1)
-                {
-                    // UTF16LE unicode
-                    uint32_t r = 0;
-                    uint32_t w = 0;
-                    if ((data_len > 2) && (buff[0] == 0xFF) && (buff[1] == 0xFE))
-                    {
-                        // ignore BOM, assume LE
-                        r = 2;
-                    }
-                    for (; r < data_len; r += 2, w += 1)
-                    {
-                        // should be acceptable for 7 bit ascii
-                        buff[w] = buff[r];
-                    }
-                    buff[w] = 0;
-                }
-            }
-            else
-            {
-                return 1;
-            }
+            bytes += entry_bytes;
+            entry++;
+            entry_bytes = 0;
         }
-        else
+        if (entry_bytes == 0 && entry < entries)
         {
-            // we won't read a partial text
-            if (fseek(fp, ftell(fp) + data_len, SEEK_SET) != 0)
-            {
-                return 1;
-            }
+            for (j = 0; j < entry_size; j++)
+                entry_bytes = (entry_bytes << 8) | table[entry * entry_size + j];
+            entry_bytes *= scale;
         }
+        /* interpolate inside the entry */
+        pos = bytes + (uint64_t)entry_bytes * (frame - entry * entry_frames) / entry_frames;
+        pos = pos * 256 / mp3_info->vbr_bytes;
+        mp3_info->toc[i] = pos > 255 ? 255 : pos;
     }
-    else
-    {
-        return 1;
-    }
-    return 0;
+    mp3_info->toc_valid = 1;
 }
 
 /**
- * @description: id3v2 decode
- * @param {FILE} *fp
- * @param {mp3_basic_info_t} *mp3_info
- * @return {*}
- * @verbatim  Taken from http://www.mikrocontroller.net/topic/252319
+ * @description: get data start from the ID3v2 header only,without walking its frames
+ * @param {mp3_file_t} fp
+ * @return {uint32_t} whole tag size,0 if there is no tag
  */
-static uint32_t mp3_id3v2_tag_decode(FILE *fp, mp3_basic_info_t *mp3_info)
+uint32_t mp3_tag_data_start(mp3_file_t fp)
 {
-    ID3V2_TagHead_t id3_head;
-    ID3V23_FrameHead_t frame_head;
+    uint8_t header[10];
 
-    uint32_t ret = 0;
+    if (fp == MP3_FILE_NULL)
+        return 0;
 
-    uint32_t tag_size = 0;
-    long int file_pos = 0;
+    if (mp3_file_seek(fp, 0, SEEK_SET) != 0 || mp3_file_read(fp, header, 10) != 10)
+        return 0;
+
+    return mp3_id3v2_tag_size(header);
+}
+
+/**
+ * @description: parse tags and vbr header of a file,no decoder is needed
+ * @param {mp3_file_t} fp
+ * @param {mp3_info_t} *mp3_info
+ * @param {uint8_t} *buf scratch buffer
+ * @param {uint32_t} size scratch buffer size,no less than 512 bytes
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_info_parse(mp3_file_t fp, mp3_info_t *mp3_info, uint8_t *buf, uint32_t size)
+{
+    rt_err_t ret = RT_ERROR;
+
+    MP3_FrameXing_t *fxing;
+    MP3_FrameVBRI_t *fvbri;
+    mp3_frame_header_t header;
+    uint8_t vbr_frame = 0;
 
     uint32_t offset = 0;
-    uint8_t exhd[4];
-    uint32_t frame_to_read = 2;
-    uint32_t i;
-    uint32_t frame_size = 0;
+    uint32_t p;
+    uint32_t read_size = 0;
 
-    if (fp == RT_NULL || mp3_info == RT_NULL)
-        return 0;
+    if (fp == MP3_FILE_NULL || buf == RT_NULL || size < 512)
+        return RT_ERROR;
+    memset(mp3_info, 0, sizeof(mp3_info_t));
 
-    file_pos = ftell(fp); /* save current file positon */
+    /* get file size */
+    mp3_info->file_size = mp3_file_size(fp);
+    mp3_file_seek(fp, 0, SEEK_SET);
+    LOG_D("file size:%d KB", mp3_info->file_size / 1024);
 
-    if (fread(&id3_head, 1, 10, fp) != 10)
-    {
-        ret = 0;
-        goto __exit;
-    }
-    else
+    /* decode ID3V1 tag,audio data ends before it */
+    mp3_info->data_end = mp3_info->file_size;
+    if (mp3_id3v1_tag_decode(fp, buf, &mp3_info->mp3_basic_info) == RT_EOK)
+        mp3_info->data_end -= 128;
+
+    /* decode ID3V2 tag,its fields take precedence over ID3V1 */
+    mp3_info->data_start = mp3_id3v2_parse(fp, &mp3_info->mp3_basic_info, buf, size);
+
+    LOG_D("mp3 data start at :%f KB", mp3_info->data_start / 1024.0);
+
+    /* find the first frame */
+    mp3_file_seek(fp, mp3_info->data_start, SEEK_SET);
+    while ((read_size = mp3_file_read(fp, buf, size)) >= MP3_FRAME_HEADER_SIZE)
     {
-        /* check header */
-        if (strncmp("ID3", (const char *)id3_head.id, 3) == 0)
+        for (offset = 0; offset + MP3_FRAME_HEADER_SIZE <= read_size; offset++)
         {
-            offset += 10; /* move to tag frame */
-            tag_size = ((id3_head.size[0] & 0x7f) << 21) | ((id3_head.size[1] & 0x7f) << 14) | ((id3_head.size[2] & 0x7f) << 7) | (id3_head.size[3] & 0x7f);
-            ret = tag_size;
-            LOG_D("tag_size:%.2f kB", tag_size / 1024.0);
-            // try to get some information from the tag
-            // skip the extended header, if present
-            if (id3_head.flags & 0x40)
-            {
-                fread(&exhd, 1, 4, fp);
-                uint32_t ex_hdr_skip = ((exhd[0] & 0x7f) << 21) | ((exhd[1] & 0x7f) << 14) | ((exhd[2] & 0x7f) << 7) | (exhd[3] & 0x7f);
-                ex_hdr_skip -= 4;
-                if (fseek(fp, ftell(fp) + ex_hdr_skip, SEEK_SET) != 0)
-                {
-                    ret = 0;
-                    goto __exit;
-                }
-            }
-            while (frame_to_read > 0)
+            if (mp3_frame_header_parse(buf + offset, &header) == RT_EOK)
             {
-                if (fread(&frame_head, 1, 10, fp) != 10)
-                {
-                    ret = 0;
-                    goto __exit;
-                }
-                if (frame_head.id[0] == 0 || (strncmp((const char*)frame_head.id, "3DI", 3) == 0))
-                {
-                    break;
-                }
-                for (; i < 4; i++)
-                {
-                    if (id3_head.mversion == 3)
-                    {
-                        /* ID3v2.3 */
-                        frame_size <<= 8;
-                        frame_size += frame_head.size[i];
-                    }
-                    if (id3_head.mversion == 4)
-                    {
-                        /* ID3v2.4 */
-                        frame_size <<= 7;
-                        frame_size += frame_head.size[i] & 0x7F;
-                    }
-                }
-
-                if (strcmp((const char*)frame_head.id, "TPE1") == 0)
-                {
-                    /* artist */
-                    if (mp3_read_id3v2_text(fp, frame_size, mp3_info->artist, 30) != 0)
-                    {
-                        break;
-                    }
-                    frame_to_read--;
-                }
-                else if (strcmp((const char*)frame_head.id, "TIT2") == 0)
-                {
-                    /* title */
-                    if (mp3_read_id3v2_text(fp, frame_size,mp3_info->title, 30) != 0)
-                    {
-                        break;
-                    }
-                    frame_to_read--;
-                }
-                else
-                {
-                    if (fseek(fp, ftell(fp) + frame_size, SEEK_SET) != 0)
-                    {
-                        return 0;
-                    }
-                }
+                ret = RT_EOK;
+                break;
             }
         }
+        if (ret == RT_EOK)
+        {
+            mp3_info->data_start += offset;
+            break;
+        }
+        /* keep the last bytes, a header may cross the block boundary */
+        mp3_info->data_start += read_size - (MP3_FRAME_HEADER_SIZE - 1);
+        mp3_file_seek(fp, mp3_info->data_start, SEEK_SET);
     }
-__exit:
-    fseek(fp, file_pos, SEEK_SET); /* resume file positon */
-    return ret;
+    if (ret != RT_EOK)
+    {
+        LOG_E("can not find sync frame");
+        return ret;
+    }
+
+    /* reload the first frame to the buffer head so the whole vbr header is buffered */
+    LOG_D("first frame at:%d", mp3_info->data_start);
+    mp3_file_seek(fp, mp3_info->data_start, SEEK_SET);
+    read_size = mp3_file_read(fp, buf, size);
+    mp3_info->audio_start = mp3_info->data_start;
+
+    p = 4 + 32;
+    fvbri = (MP3_FrameVBRI_t *)(buf + p);
+    if (p + sizeof(MP3_FrameVBRI_t) <= read_size && strncmp("VBRI", (char *)fvbri->id, 4) == 0) /* VBRI frame*/
+    {
+        mp3_vbri_decode(fvbri, read_size - p, mp3_info);
+        vbr_frame = 1;
+    }
+    else /* maybe is Xing frame*/
+    {
+        if (header.version == MPEG1)
+            p = header.channels == 2 ? 32 : 17;
+        else
+            p = header.channels == 2 ? 17 : 9;
+        p += 4;
+        fxing = (MP3_FrameXing_t *)(buf + p);
+        if (p + sizeof(MP3_FrameXing_t) <= read_size &&
+            (strncmp("Xing", (char *)fxing->id, 4) == 0 || strncmp("Info", (char *)fxing->id, 4) == 0))
+        {
+            mp3_xing_decode(fxing, read_size - p, mp3_info);
+            vbr_frame = 1;
+        }
+    }
+
+    /* the Xing/VBRI frame carries no audio, playback starts after it */
+    if (vbr_frame)
+        mp3_info->audio_start = mp3_info->data_start + header.frame_size;
+
+    if (mp3_info->total_frames) /* frame count is valid */
+    {
+        mp3_info->total_samples = mp3_info->total_frames * header.samples;
+        mp3_info->total_seconds = (uint64_t)mp3_info->total_frames * header.samples / header.samplerate; /* get total length */
+        mp3_info->vbr = 1;
+    }
+    else /* CBR Format,or vbr without a header which needs mp3_info_exact */
+    {
+        if (mp3_info->data_end > mp3_info->audio_start)
+            mp3_info->total_seconds = (mp3_info->data_end - mp3_info->audio_start) / (header.bitrate / 8);
+        mp3_info->vbr = 0;
+    }
+    if (mp3_info->vbr_bytes == 0)
+        mp3_info->vbr_bytes = mp3_info->data_end - mp3_info->data_start;
+    mp3_info->bitrate = header.bitrate;
+    mp3_info->samplerate = header.samplerate;
+    mp3_info->outsamples = header.samples * 2; /* mono is expanded to stereo */
+
+    return RT_EOK;
+}
+
+/*
+ * frame walk state of mp3_info_exact
+ */
+struct mp3_exact_walk
+{
+    mp3_frame_header_t first;
+    uint32_t frames;
+    uint32_t samples;
+    uint8_t vbr;
+};
+
+static rt_err_t mp3_exact_walk_cb(void *user, uint32_t frame, uint32_t offset, const mp3_frame_header_t *header)
+{
+    struct mp3_exact_walk *walk = (struct mp3_exact_walk *)user;
+
+    if (frame == 0)
+        walk->first = *header;
+    else if (!mp3_frame_header_match(&walk->first, header))
+        return RT_EOK; /* false sync in damaged data,not counted */
+    else if (header->bitrate != walk->first.bitrate)
+        walk->vbr = 1;
+
+    walk->frames++;
+    walk->samples += header->samples;
+
+    return RT_EOK;
 }
 
 /**
- * @description: get mp3 tag info
- * @param {struct mp3_player} *player
- * @return the error code,0 on success
+ * @description: set duration from an exact frame count
+ * @param {mp3_info_t} *mp3_info
+ * @param {uint32_t} frames
+ * @param {uint32_t} samples samples per channel of all frames
+ * @param {uint32_t} samplerate
+ * @return None
  */
-rt_err_t mp3_get_info(struct mp3_player *player)
+void mp3_info_exact_set(mp3_info_t *mp3_info, uint32_t frames, uint32_t samples, uint32_t samplerate)
 {
-    rt_err_t ret = RT_EOK;
+    if (frames == 0 || samples == 0 || samplerate == 0)
+        return;
+
+    mp3_info->total_frames = frames;
+    mp3_info->total_samples = samples;
+    mp3_info->total_seconds = samples / samplerate;
+    /* average over the audio data,seeking by bitrate lands closer */
+    mp3_info->bitrate = (uint64_t)(mp3_info->data_end - mp3_info->audio_start) * 8 * samplerate / samples;
+    mp3_info->exact = 1;
+}
 
-    MP3FrameInfo frame_info;
-    MP3_FrameXing_t *fxing;
-    MP3_FrameVBRI_t *fvbri;
+/**
+ * @description: count frames of a file without a Xing/VBRI header by walking frame headers,
+ *               audio is not decoded,a large buffer makes the walk faster
+ * @param {mp3_file_t} fp
+ * @param {mp3_info_t} *mp3_info parsed by mp3_info_parse
+ * @param {uint8_t} *buf scratch buffer used for block reads
+ * @param {uint32_t} size scratch buffer size,no less than 512 bytes
+ * @param {volatile rt_uint8_t} *cancel walk stops when it becomes non-zero,can be RT_NULL
+ * @return the error code,0 on success,-RT_EINTR if cancelled
+ */
+rt_err_t mp3_info_exact(mp3_file_t fp, mp3_info_t *mp3_info, uint8_t *buf, uint32_t size, volatile rt_uint8_t *cancel)
+{
+    struct mp3_exact_walk walk;
+#if (LOG_LVL >= DBG_LOG)
+    rt_tick_t tick = rt_tick_get();
+#endif
 
-    int offset = 0;
-    uint32_t p;
-    short samples_per_frame;
-    uint32_t total_frame;
+    if (mp3_info->total_frames)
+        return RT_EOK; /* counted by the encoder */
 
-    uint32_t read_size = 0;
-    long int file_pos = 0;
+    memset(&walk, 0, sizeof(walk));
+    mp3_frame_walk(fp, mp3_info->audio_start, mp3_info->data_end, buf, size, mp3_exact_walk_cb, &walk, cancel);
+    if (cancel && *cancel)
+        return -RT_EINTR;
+    if (walk.frames == 0)
+        return RT_ERROR;
 
-    if (player->fp == NULL)
+    mp3_info_exact_set(mp3_info, walk.frames, walk.samples, walk.first.samplerate);
+    mp3_info->vbr = walk.vbr;
+#if (LOG_LVL >= DBG_LOG)
+    LOG_D("%d frames, %d bit/s average, %d ms", walk.frames, mp3_info->bitrate,
+          (rt_tick_get() - tick) * 1000 / RT_TICK_PER_SECOND);
+#endif
+
+    return RT_EOK;
+}
+
+/**
+ * @description: parse mp3 info of a file,reentrant,only the caller's buffers are used
+ * @param {const char} *path
+ * @param {mp3_info_t} *info
+ * @param {uint8_t} *scratch
+ * @param {uint32_t} size scratch size,no less than 512 bytes
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_probe(const char *path, mp3_info_t *info, uint8_t *scratch, uint32_t size)
+{
+    mp3_file_t fp;
+    rt_err_t ret;
+
+    fp = mp3_file_open(path);
+    if (fp == MP3_FILE_NULL)
     {
-        LOG_E("%s is not opened", player->uri);
+        memset(info, 0, sizeof(mp3_info_t));
         return RT_ERROR;
     }
-    file_pos = ftell(player->fp); /* save current file positon */
-    LOG_D("current file pos:%d", file_pos);
-    memset(&player->mp3_info, 0, sizeof(mp3_info_t));
-
-    /* get file size */
-    fseek(player->fp, 0, SEEK_END);
-    player->mp3_info.file_size = ftell(player->fp);
-    fseek(player->fp, 0, SEEK_SET);
-    LOG_D("%s:%d KB,%.2f MB", player->uri, player->mp3_info.file_size / 1024, player->mp3_info.file_size / 1024 / 1024.0);
+    ret = mp3_info_parse(fp, info, scratch, size);
+    mp3_file_close(fp);
 
-    player->mp3_info.data_start = mp3_id3v2_tag_decode(player->fp, &player->mp3_info.mp3_basic_info); /* decode ID3V2 tag*/
-
-    mp3_id3v1_tag_decode(player->fp, player->in_buffer, &player->mp3_info.mp3_basic_info); /* decode ID3V1 tag */
+    return ret;
+}
 
-    LOG_D("mp3 data start at :%f KB", player->mp3_info.data_start / 1024.0);
+/**
+ * @description: parse mp3 info of a file with exact duration,reentrant
+ * @param {const char} *path
+ * @param {mp3_info_t} *info
+ * @param {uint8_t} *scratch
+ * @param {uint32_t} size scratch size,no less than 512 bytes
+ * @param {volatile rt_uint8_t} *cancel walk stops when it becomes non-zero,can be RT_NULL
+ * @return the error code,0 on success,-RT_EINTR if cancelled
+ */
+rt_err_t mp3_probe_exact(const char *path, mp3_info_t *info, uint8_t *scratch, uint32_t size,
+                         volatile rt_uint8_t *cancel)
+{
+    mp3_file_t fp;
+    rt_err_t ret;
 
-    fseek(player->fp, player->mp3_info.data_start, SEEK_SET);
-    while ((read_size = fread(player->in_buffer, 1, MP3_INPUT_BUFFER_SIZE, player->fp)))
+    fp = mp3_file_open(path);
+    if (fp == MP3_FILE_NULL)
     {
-        if ((offset = MP3FindSyncWord(player->in_buffer, read_size)) >= 0)
-            break;
+        memset(info, 0, sizeof(mp3_info_t));
+        return RT_ERROR;
     }
+    ret = mp3_info_parse(fp, info, scratch, size);
+    if (ret == RT_EOK)
+        ret = mp3_info_exact(fp, info, scratch, size, cancel);
+    mp3_file_close(fp);
 
-    LOG_D("sync word offset at:%d", offset);
-    if (offset >= 0 && MP3GetNextFrameInfo(player->mp3_decoder, &frame_info, &player->in_buffer[offset]) == 0)
-    {
+    return ret;
+}
 
-        p = offset + 4 + 32;
-        fvbri = (MP3_FrameVBRI_t *)(player->in_buffer + p);
-        if (strncmp("VBRI", (char *)fvbri->id, 4) == 0) /* VBRI frame*/
-        {
-            if (frame_info.version == MPEG1)
-                samples_per_frame = 1152;
-            else
-                samples_per_frame = 576;
-            total_frame = ((uint32_t)fvbri->frames[0] << 24) | ((uint32_t)fvbri->frames[1] << 16) | ((uint16_t)fvbri->frames[2] << 8) | fvbri->frames[3]; /* get total frame */
-            player->mp3_info.total_seconds = total_frame * samples_per_frame / frame_info.samprate;                                                       /* get total length */
-        }
-        else /* maybe is Xing frame*/
+/**
+ * @description: parse mp3 info of files in one directory,reentrant,
+ *               the directory path is joined once and the scratch buffer is shared
+ * @param {const char} *dir
+ * @param {const char *const} *names file names in dir
+ * @param {uint32_t} count
+ * @param {mp3_info_t} *infos count entries,zeroed for files that fail
+ * @param {uint8_t} *scratch
+ * @param {uint32_t} size scratch size,no less than 512 bytes
+ * @return {uint32_t} files parsed
+ */
+uint32_t mp3_probe_dir(const char *dir, const char *const *names, uint32_t count,
+                       mp3_info_t *infos, uint8_t *scratch, uint32_t size)
+{
+    char path[MP3_PROBE_PATH_MAX];
+    uint32_t len, i, done = 0;
+
+    len = strlen(dir);
+    if (len + 2 > sizeof(path))
+        return 0;
+    memcpy(path, dir, len);
+    if (len == 0 || path[len - 1] != '/')
+        path[len++] = '/';
+
+    for (i = 0; i < count; i++)
+    {
+        /* only the file name is rewritten */
+        if (len + strlen(names[i]) >= sizeof(path))
         {
-            if (frame_info.version == MPEG1)
-            {
-                p = frame_info.nChans == 2 ? 32 : 17;
-                samples_per_frame = 1152;
-            }
-            else
-            {
-                p = frame_info.nChans == 2 ? 17 : 9;
-                samples_per_frame = 576;
-            }
-            p += offset + 4;
-            fxing = (MP3_FrameXing_t *)(player->in_buffer + p);
-            if (strncmp("Xing", (char *)fxing->id, 4) == 0 || strncmp("Info", (char *)fxing->id, 4) == 0)
-            {
-                if (fxing->flags[3] & 0X01) /* TOC is valid */
-                {
-                    total_frame = ((uint32_t)fxing->frames[0] << 24) | ((uint32_t)fxing->frames[1] << 16) | ((uint16_t)fxing->frames[2] << 8) | fxing->frames[3]; /* get total flame */
-
-                    player->mp3_info.total_seconds = total_frame * samples_per_frame / frame_info.samprate; /* get total length */
-                    player->mp3_info.vbr = 1;
-                }
-                else
-                {
-                    player->mp3_info.total_seconds = (player->mp3_info.file_size - (128 + player->mp3_info.data_start)) / (frame_info.bitrate / 8);
-                    player->mp3_info.vbr = 0;
-                }
-            }
-            else /* CBR Format */
-            {
-                player->mp3_info.total_seconds = (player->mp3_info.file_size - (128 + player->mp3_info.data_start)) / (frame_info.bitrate / 8);
-                player->mp3_info.vbr = 0;
-            }
+            memset(&infos[i], 0, sizeof(mp3_info_t));
+            continue;
         }
-        player->mp3_info.bitrate = frame_info.bitrate;
-        player->mp3_info.samplerate = frame_info.samprate;
-        if (frame_info.nChans == 2)
-            player->mp3_info.outsamples = frame_info.outputSamps;
-        else
-            player->mp3_info.outsamples = frame_info.outputSamps * 2;
+        strcpy(path + len, names[i]);
+        if (mp3_probe(path, &infos[i], scratch, size) == RT_EOK)
+            done++;
     }
-    else
+
+    return done;
+}
+
+/**
+ * @description: get mp3 tag info
+ * @param {struct mp3_player} *player
+ * @return the error code,0 on success
+ */
+rt_err_t mp3_get_info(struct mp3_player *player)
+{
+    if (player->fp == MP3_FILE_NULL)
     {
-        LOG_E("can not find sync frame");
-        ret = RT_ERROR;
+        LOG_E("%s is not opened", player->uri);
+        return RT_ERROR;
     }
-	
-//__exit:
-//    if (player->fp)
-//        fsetpos(player->fp, &file_pos); /* resume file positon */
-    return ret;
+
+    return mp3_info_parse(player->fp, &player->mp3_info, player->in_buffer, MP3_INPUT_BUFFER_SIZE);
 }